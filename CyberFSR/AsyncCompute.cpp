@@ -0,0 +1,147 @@
+#include "pch.h"
+#include "Util.h"
+#include "DirectXHooks.h"
+#include "AsyncCompute.h"
+
+class AsyncCompute::Queues : public AsyncComputeQueues
+{
+public:
+	Queues(AsyncCompute& asyncCompute, ID3D12CommandQueue* engineQueue) : asyncCompute(asyncCompute), engineQueue(engineQueue) {}
+
+	bool CreateSlot(unsigned int slot) override
+	{
+		auto& frame = asyncCompute.frames[slot];
+		auto* device = asyncCompute.device;
+
+		if (FAILED(device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COMPUTE, IID_PPV_ARGS(&frame.Allocator)))
+			|| FAILED(device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COMPUTE, frame.Allocator, nullptr, IID_PPV_ARGS(&frame.CommandList)))
+			|| FAILED(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&frame.Fence))))
+		{
+			printf("Couldn't create async compute slot %u\n", slot);
+			return false;
+		}
+
+		ThrowIfFailed(frame.CommandList->Close());
+		HookComputeCommandList(frame.CommandList);
+
+		return true;
+	}
+
+	void ResetSlot(unsigned int slot, uint64_t value) override
+	{
+		auto& frame = asyncCompute.frames[slot];
+
+		//the allocator can only be reset once the GPU is done with the slot's previous upscale
+		if (frame.Fence->GetCompletedValue() < value)
+		{
+			ThrowIfFailed(frame.Fence->SetEventOnCompletion(value, asyncCompute.fenceEvent));
+			WaitForSingleObject(asyncCompute.fenceEvent, INFINITE);
+		}
+
+		ThrowIfFailed(frame.Allocator->Reset());
+		ThrowIfFailed(frame.CommandList->Reset(frame.Allocator, nullptr));
+	}
+
+	void AbandonSlot(unsigned int slot, uint64_t value) override
+	{
+		auto& frame = asyncCompute.frames[slot];
+
+		ThrowIfFailed(frame.CommandList->Close());
+		ThrowIfFailed(asyncCompute.computeQueue->Signal(frame.Fence, value));
+	}
+
+	void ExecuteEngineLists(const void* const* commandLists, unsigned int count) override
+	{
+		oExecuteCommandLists(engineQueue, count, reinterpret_cast<ID3D12CommandList* const*>(commandLists));
+	}
+
+	void SignalInputs(uint64_t value) override
+	{
+		ThrowIfFailed(engineQueue->Signal(asyncCompute.inputFence, value));
+	}
+
+	void WaitInputs(uint64_t value) override
+	{
+		ThrowIfFailed(asyncCompute.computeQueue->Wait(asyncCompute.inputFence, value));
+	}
+
+	void ExecuteUpscale(unsigned int slot, uint64_t value) override
+	{
+		auto& frame = asyncCompute.frames[slot];
+
+		ThrowIfFailed(frame.CommandList->Close());
+		ID3D12CommandList* computeLists[] = { frame.CommandList };
+		oExecuteCommandLists(asyncCompute.computeQueue, 1, computeLists);
+		ThrowIfFailed(asyncCompute.computeQueue->Signal(frame.Fence, value));
+	}
+
+	void WaitUpscale(unsigned int slot, uint64_t value) override
+	{
+		ThrowIfFailed(engineQueue->Wait(asyncCompute.frames[slot].Fence, value));
+	}
+
+private:
+	AsyncCompute& asyncCompute;
+	ID3D12CommandQueue* engineQueue;
+};
+
+void AsyncCompute::Initialize(ID3D12Device* device)
+{
+	this->device = device;
+
+	D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+	queueDesc.Type = D3D12_COMMAND_LIST_TYPE_COMPUTE;
+	ThrowIfFailed(device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&computeQueue)));
+	computeQueue->SetName(L"CyberFSR_AsyncCompute");
+
+	ThrowIfFailed(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&inputFence)));
+	fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+
+	//every queue of the device shares this vtable, so this also catches the engine's submissions
+	HookExecuteCommandLists(computeQueue);
+}
+
+ID3D12GraphicsCommandList* AsyncCompute::Begin(ID3D12GraphicsCommandList* engineCmdList)
+{
+	std::call_once(initialized, [this, engineCmdList]()
+	{
+		ID3D12Device* device;
+		engineCmdList->GetDevice(IID_PPV_ARGS(&device));
+		Initialize(device);
+		device->Release();
+	});
+
+	Queues queues(*this, nullptr);
+	unsigned int slot;
+
+	if (!scheduler.Begin(engineCmdList, queues, &slot))
+	{
+		printf("No async compute slot left, %u engine command lists wait for their submission\n", AsyncComputeScheduler::MaxSlots);
+		return nullptr;
+	}
+
+	return frames[slot].CommandList;
+}
+
+bool AsyncCompute::TakeFence(ID3D12GraphicsCommandList* engineCmdList, ID3D12Fence** fence, UINT64* value)
+{
+	unsigned int slot;
+	uint64_t fenceValue;
+
+	if (!scheduler.TakeFence(engineCmdList, &slot, &fenceValue))
+		return false;
+
+	*fence = frames[slot].Fence;
+	*value = fenceValue;
+
+	return true;
+}
+
+void AsyncCompute::Submit(ID3D12CommandQueue* queue, UINT numCommandLists, ID3D12CommandList* const* commandLists)
+{
+	if (queue == computeQueue)
+		return oExecuteCommandLists(queue, numCommandLists, commandLists);
+
+	Queues queues(*this, queue);
+	scheduler.Submit(reinterpret_cast<const void* const*>(commandLists), numCommandLists, queues);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "pch.h"
+#include "AsyncComputeScheduler.h"
+
+/*
+Records FSR2 on a command list owned by the shim instead of the engine's graphics command list and runs it on a compute queue.
+The upscale only needs color, depth and motion vectors, so once the engine submits the command list that produced them we split its ExecuteCommandLists call:
+lists up to that one run first and signal a fence, the compute queue waits on it and runs the upscale, the rest of the submission waits for the upscale.
+Engines that know where the output gets consumed can take over that last wait through CyberFSR_D3D12_GetAsyncComputeFence and overlap everything in between.
+Without that call nothing overlaps the upscale, the split only adds two fence waits, so unmodified titles are not faster with async compute.
+The output must not be consumed later in the same command list that EvaluateFeature got called with.
+The FSR2 DX12 backend only knows graphics queue states, the shim's lists translate its barriers for the compute queue (see HookComputeCommandList).
+*/
+class AsyncCompute
+{
+public:
+	//returns the shim command list FSR2 gets recorded into for work that belongs to engineCmdList, nullptr if no slot is left
+	ID3D12GraphicsCommandList* Begin(ID3D12GraphicsCommandList* engineCmdList);
+
+	//the caller waits for the upscale of engineCmdList itself instead of the rest of the submission
+	bool TakeFence(ID3D12GraphicsCommandList* engineCmdList, ID3D12Fence** fence, UINT64* value);
+
+	void Submit(ID3D12CommandQueue* queue, UINT numCommandLists, ID3D12CommandList* const* commandLists);
+
+	static AsyncCompute& instance()
+	{
+		static AsyncCompute INSTANCE;
+		return INSTANCE;
+	}
+
+private:
+	AsyncCompute() {}
+
+	struct Frame
+	{
+		ID3D12CommandAllocator* Allocator = nullptr;
+		ID3D12GraphicsCommandList* CommandList = nullptr;
+		ID3D12Fence* Fence = nullptr;
+	};
+
+	//the D3D12 side of the scheduler's decisions, engineQueue is only known while submitting
+	class Queues;
+
+	std::once_flag initialized;
+	ID3D12Device* device = nullptr;
+	ID3D12CommandQueue* computeQueue = nullptr;
+	Frame frames[AsyncComputeScheduler::MaxSlots];
+	HANDLE fenceEvent = nullptr;
+	ID3D12Fence* inputFence = nullptr;
+
+	AsyncComputeScheduler scheduler;
+
+	void Initialize(ID3D12Device* device);
+};
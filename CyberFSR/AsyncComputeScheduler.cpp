@@ -0,0 +1,161 @@
+#include "AsyncComputeScheduler.h"
+
+#include <cstdio>
+
+bool AsyncComputeScheduler::Stale(const Slot& slot) const
+{
+	//engines record ahead and evaluate several views per frame, only a list that fell behind a whole set of slots counts as dropped
+	return slot.Pending && submittedUpscales - slot.ReservedAt >= MaxSlots;
+}
+
+void AsyncComputeScheduler::Abandon(unsigned int index, AsyncComputeQueues& queues)
+{
+	auto& slot = slots[index];
+	printf("Dropping the async compute upscale of an engine command list that never got submitted\n");
+
+	queues.AbandonSlot(index, slot.FenceValue);
+	pending.erase(slot.EngineCmdList);
+	slot.Pending = false;
+}
+
+bool AsyncComputeScheduler::Begin(const void* engineCmdList, AsyncComputeQueues& queues, unsigned int* slot)
+{
+	unsigned int index;
+	uint64_t previousValue;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		//several features evaluated into the same engine list share one upscale submission
+		if (auto it = pending.find(engineCmdList); it != pending.end())
+		{
+			if (!Stale(slots[it->second]))
+			{
+				*slot = it->second;
+				return true;
+			}
+
+			//the engine reset the list instead of submitting it
+			Abandon(it->second, queues);
+		}
+
+		index = static_cast<unsigned int>(slots.size());
+
+		//reuse the oldest idle slot once the regular frames in flight are covered
+		if (slots.size() >= FrameCount)
+		{
+			for (unsigned int i = 0; i < slots.size(); i++)
+			{
+				const unsigned int candidate = (nextSlot + i) % slots.size();
+				if (!slots[candidate].Pending)
+				{
+					index = candidate;
+					break;
+				}
+			}
+		}
+
+		if (index == slots.size() && slots.size() == MaxSlots)
+		{
+			for (unsigned int i = 0; i < slots.size(); i++)
+			{
+				if (Stale(slots[i]) && (index == slots.size() || slots[i].ReservedAt < slots[index].ReservedAt))
+					index = i;
+			}
+
+			if (index == slots.size())
+				return false;
+
+			Abandon(index, queues);
+		}
+
+		if (index == slots.size())
+		{
+			if (!queues.CreateSlot(index))
+				return false;
+
+			slots.emplace_back();
+		}
+
+		auto& current = slots[index];
+		nextSlot = (index + 1) % slots.size();
+
+		previousValue = current.FenceValue;
+		current.FenceValue++;
+		current.ReservedAt = submittedUpscales;
+		current.EngineCmdList = engineCmdList;
+		current.Pending = true;
+		current.EngineWaits = false;
+
+		pending[engineCmdList] = index;
+		hasPending = true;
+	}
+
+	//the slot's last upscale got submitted or abandoned, so its fence reaches the value
+	queues.ResetSlot(index, previousValue);
+
+	*slot = index;
+	return true;
+}
+
+bool AsyncComputeScheduler::TakeFence(const void* engineCmdList, unsigned int* slot, uint64_t* value)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto it = pending.find(engineCmdList);
+	if (it == pending.end())
+		return false;
+
+	auto& current = slots[it->second];
+	current.EngineWaits = true;
+	*slot = it->second;
+	*value = current.FenceValue;
+
+	return true;
+}
+
+void AsyncComputeScheduler::Submit(const void* const* commandLists, unsigned int count, AsyncComputeQueues& queues)
+{
+	if (!hasPending)
+		return queues.ExecuteEngineLists(commandLists, count);
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	unsigned int first = 0;
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		auto it = pending.find(commandLists[i]);
+		if (it == pending.end())
+			continue;
+
+		const unsigned int index = it->second;
+		auto& current = slots[index];
+		pending.erase(it);
+
+		//everything up to the list that produced the inputs
+		queues.ExecuteEngineLists(commandLists + first, i + 1 - first);
+		first = i + 1;
+
+		queues.SignalInputs(++inputFenceValue);
+		queues.WaitInputs(inputFenceValue);
+		queues.ExecuteUpscale(index, current.FenceValue);
+
+		if (!current.EngineWaits)
+			queues.WaitUpscale(index, current.FenceValue);
+
+		current.Pending = false;
+		submittedUpscales++;
+	}
+
+	if (first < count)
+		queues.ExecuteEngineLists(commandLists + first, count - first);
+
+	hasPending = !pending.empty();
+}
+
+unsigned int AsyncComputeScheduler::SlotCount()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return static_cast<unsigned int>(slots.size());
+}
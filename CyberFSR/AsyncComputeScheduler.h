@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/*
+Queue and fence operations the AsyncComputeScheduler decides on, implemented on D3D12 by AsyncCompute and by a recording fake in the tests.
+Every slot owns a shim command list, its allocator and a fence the compute queue signals once the slot's upscale completed.
+*/
+class AsyncComputeQueues
+{
+public:
+	virtual ~AsyncComputeQueues() = default;
+
+	virtual bool CreateSlot(unsigned int slot) = 0;
+	//blocks until the slot's fence reached value, then reopens its command list for recording
+	virtual void ResetSlot(unsigned int slot, uint64_t value) = 0;
+	//closes the slot's command list without running it and signals value on the slot's fence, so nothing keeps waiting on the dropped upscale
+	virtual void AbandonSlot(unsigned int slot, uint64_t value) = 0;
+
+	virtual void ExecuteEngineLists(const void* const* commandLists, unsigned int count) = 0;
+	//the engine queue signals the input fence, the compute queue waits on it
+	virtual void SignalInputs(uint64_t value) = 0;
+	virtual void WaitInputs(uint64_t value) = 0;
+	//closes the slot's command list, runs it on the compute queue and signals the slot's fence with value
+	virtual void ExecuteUpscale(unsigned int slot, uint64_t value) = 0;
+	//the engine queue waits on the slot's fence
+	virtual void WaitUpscale(unsigned int slot, uint64_t value) = 0;
+};
+
+/*
+Every engine command list an upscale got evaluated into holds a slot until the engine submits it.
+Engines can record several lists before submitting any of them, so the slots grow instead of recycling one that is still pending,
+a pending slot's upscale is already part of the FSR2 history and its fence value may have been handed out through TakeFence.
+A list that stays behind while MaxSlots later upscales got submitted was dropped by the engine, its slot gets reclaimed when the list comes back or the slots run out.
+Begin only reserves the slot under the lock, waiting for the slot's previous upscale happens outside so submissions from other threads keep going.
+*/
+class AsyncComputeScheduler
+{
+public:
+	static constexpr unsigned int FrameCount = 3;
+	static constexpr unsigned int MaxSlots = 16;
+
+	//false if MaxSlots engine lists are waiting for their submission already and none of them got dropped
+	bool Begin(const void* engineCmdList, AsyncComputeQueues& queues, unsigned int* slot);
+
+	//the caller waits for the upscale of engineCmdList itself instead of the rest of the submission
+	bool TakeFence(const void* engineCmdList, unsigned int* slot, uint64_t* value);
+
+	void Submit(const void* const* commandLists, unsigned int count, AsyncComputeQueues& queues);
+
+	unsigned int SlotCount();
+
+private:
+	struct Slot
+	{
+		uint64_t FenceValue{};
+		//submittedUpscales when the slot got reserved
+		uint64_t ReservedAt{};
+		const void* EngineCmdList = nullptr;
+		bool Pending{}, EngineWaits{};
+	};
+
+	bool Stale(const Slot& slot) const;
+	void Abandon(unsigned int index, AsyncComputeQueues& queues);
+
+	std::mutex mutex;
+	std::vector<Slot> slots;
+	unsigned int nextSlot{};
+	uint64_t submittedUpscales{};
+
+	//signaled on the engine queue once the lists producing the FSR2 inputs completed
+	uint64_t inputFenceValue{};
+
+	std::unordered_map<const void*, unsigned int> pending;
+	std::atomic<bool> hasPending{};
+};
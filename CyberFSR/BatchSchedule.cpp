@@ -0,0 +1,93 @@
+#include "BatchSchedule.h"
+
+thread_local BatchBinds batchBinds;
+
+std::vector<std::pair<size_t, size_t>> InterleaveJobs(const std::vector<std::vector<int>>& jobKeys)
+{
+	std::vector<std::pair<size_t, size_t>> order;
+	std::vector<size_t> next(jobKeys.size());
+
+	//a key another feature only reaches after some of its other jobs has to wait for that feature
+	auto pendingElsewhere = [&](size_t feature, int key)
+	{
+		for (size_t other = 0; other < jobKeys.size(); other++)
+		{
+			if (other == feature)
+				continue;
+
+			for (size_t job = next[other] + 1; job < jobKeys[other].size(); job++)
+			{
+				if (jobKeys[other][job] == key)
+					return true;
+			}
+		}
+
+		return false;
+	};
+
+	for (;;)
+	{
+		bool found = false, remaining = false;
+		int key{};
+
+		for (size_t feature = 0; feature < jobKeys.size() && !found; feature++)
+		{
+			if (next[feature] == jobKeys[feature].size())
+				continue;
+
+			//if every candidate waits on another feature the first one runs anyway
+			if (!remaining)
+				key = jobKeys[feature][next[feature]];
+			remaining = true;
+
+			if (!pendingElsewhere(feature, jobKeys[feature][next[feature]]))
+			{
+				key = jobKeys[feature][next[feature]];
+				found = true;
+			}
+		}
+
+		if (!remaining)
+			break;
+
+		for (size_t feature = 0; feature < jobKeys.size(); feature++)
+		{
+			if (next[feature] < jobKeys[feature].size() && jobKeys[feature][next[feature]] == key)
+				order.emplace_back(feature, next[feature]++);
+		}
+	}
+
+	return order;
+}
+
+bool BatchBinds::BindRootSignature(const void* commandList, const void* rootSignature)
+{
+	if (commandList != CommandList)
+		return true;
+
+	if (rootSignature == RootSignature)
+	{
+		SkippedBinds++;
+		return false;
+	}
+
+	RootSignature = rootSignature;
+	RootSignatureBinds++;
+	return true;
+}
+
+bool BatchBinds::BindPipelineState(const void* commandList, const void* pipelineState)
+{
+	if (commandList != CommandList)
+		return true;
+
+	if (pipelineState == PipelineState)
+	{
+		SkippedBinds++;
+		return false;
+	}
+
+	PipelineState = pipelineState;
+	PipelineBinds++;
+	return true;
+}
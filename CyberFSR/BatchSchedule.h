@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/*
+Execution order of the FSR2 jobs a batched evaluation deferred, as pairs of feature and job index.
+Every feature keeps the order of its own jobs, across features jobs with the same key (the FSR2 pass) run back to back so they share their binds.
+Views with a reset, different sharpening, auto exposure or a generated reactive mask schedule different job lists, so jobs get matched by key and not by position.
+*/
+std::vector<std::pair<size_t, size_t>> InterleaveJobs(const std::vector<std::vector<int>>& jobKeys);
+
+//Binds recorded into CommandList while the shim executes a batch of FSR2 jobs, the counters stay valid until the next batch starts
+struct BatchBinds
+{
+	const void* CommandList = nullptr;
+	const void* RootSignature = nullptr;
+	const void* PipelineState = nullptr;
+	unsigned int Jobs{}, RootSignatureBinds{}, PipelineBinds{}, SkippedBinds{};
+
+	//false if the bind repeats the current one and can be skipped, binds into other command lists always go through
+	bool BindRootSignature(const void* commandList, const void* rootSignature);
+	bool BindPipelineState(const void* commandList, const void* pipelineState);
+};
+
+//filters the binds of the thread that currently executes a batch
+extern thread_local BatchBinds batchBinds;
+
+//Bodies of the SetComputeRootSignature and SetPipelineState hooks, forward calls the function the hook replaced
+template<class CommandList, class RootSignature, class Forward>
+void BatchedSetComputeRootSignature(CommandList* commandList, RootSignature* rootSignature, Forward forward)
+{
+	//FSR2 rebinds every root parameter per job, so skipping an identical root signature is safe
+	if (batchBinds.BindRootSignature(commandList, rootSignature))
+		forward(commandList, rootSignature);
+}
+
+template<class CommandList, class PipelineState, class Forward>
+void BatchedSetPipelineState(CommandList* commandList, PipelineState* pipelineState, Forward forward)
+{
+	if (batchBinds.BindPipelineState(commandList, pipelineState))
+		forward(commandList, pipelineState);
+}
+
+//Records execute(feature, job) for every pair of order into commandList while the hooks above skip repeated binds into it
+template<class Execute>
+void ExecuteBatch(const void* commandList, const std::vector<std::pair<size_t, size_t>>& order, Execute execute)
+{
+	batchBinds = {};
+	batchBinds.CommandList = commandList;
+
+	for (const auto& [feature, job] : order)
+	{
+		execute(feature, job);
+		batchBinds.Jobs++;
+	}
+
+	batchBinds.CommandList = nullptr;
+}
@@ -0,0 +1,73 @@
+#include "pch.h"
+#include "Config.h"
+
+Config::Config()
+{
+	HMODULE module = nullptr;
+	GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+		reinterpret_cast<LPCWSTR>(&Config::instance), &module);
+
+	wchar_t modulePath[MAX_PATH];
+	GetModuleFileNameW(module, modulePath, MAX_PATH);
+
+	std::wstring moduleDirectory = modulePath;
+	moduleDirectory = moduleDirectory.substr(0, moduleDirectory.find_last_of(L'\\') + 1);
+	iniPath = moduleDirectory + L"nvngx.ini";
+
+	ShareTransientResources = ReadBool(L"Memory", L"ShareTransientResources", ShareTransientResources);
+	AsyncComputeUpscale = ReadBool(L"AsyncCompute", L"Enabled", AsyncComputeUpscale);
+
+	BenchmarkEnabled = ReadBool(L"Benchmark", L"Enabled", BenchmarkEnabled);
+	BenchmarkStartKey = ReadUInt(L"Benchmark", L"StartKey", BenchmarkStartKey);
+	BenchmarkStartDelayFrames = ReadUInt(L"Benchmark", L"StartDelayFrames", BenchmarkStartDelayFrames);
+	BenchmarkSettleFrames = ReadUInt(L"Benchmark", L"SettleFrames", BenchmarkSettleFrames);
+	BenchmarkWarmupFrames = ReadUInt(L"Benchmark", L"WarmupFrames", BenchmarkWarmupFrames);
+	BenchmarkFramesPerStep = ReadUInt(L"Benchmark", L"FramesPerStep", BenchmarkFramesPerStep);
+	BenchmarkReportPath = moduleDirectory + ReadString(L"Benchmark", L"Report", L"CyberFSR_Benchmark");
+
+	//comma separated upscale ratios, e.g. 1.3,2.5
+	const std::wstring ratios = ReadString(L"Benchmark", L"CustomRatios", L"");
+	const wchar_t* ratio = ratios.c_str();
+	while (*ratio)
+	{
+		wchar_t* end;
+		const float value = wcstof(ratio, &end);
+		if (end == ratio)
+			break;
+		if (value >= 1.0f)
+			BenchmarkCustomRatios.push_back(value);
+		ratio = *end == L',' ? end + 1 : end;
+	}
+
+	ReactiveMaskEnabled = ReadBool(L"ReactiveMask", L"Enabled", ReactiveMaskEnabled);
+	ReactiveMaskScale = ReadFloat(L"ReactiveMask", L"Scale", ReactiveMaskScale);
+	ReactiveMaskCutoffThreshold = ReadFloat(L"ReactiveMask", L"CutoffThreshold", ReactiveMaskCutoffThreshold);
+	ReactiveMaskBinaryValue = ReadFloat(L"ReactiveMask", L"BinaryValue", ReactiveMaskBinaryValue);
+}
+
+bool Config::ReadBool(const wchar_t* section, const wchar_t* key, bool defaultValue) const
+{
+	return GetPrivateProfileIntW(section, key, defaultValue, iniPath.c_str()) != 0;
+}
+
+float Config::ReadFloat(const wchar_t* section, const wchar_t* key, float defaultValue) const
+{
+	const std::wstring value = ReadString(section, key, L"");
+
+	if (value.empty())
+		return defaultValue;
+
+	return wcstof(value.c_str(), nullptr);
+}
+
+unsigned int Config::ReadUInt(const wchar_t* section, const wchar_t* key, unsigned int defaultValue) const
+{
+	return GetPrivateProfileIntW(section, key, defaultValue, iniPath.c_str());
+}
+
+std::wstring Config::ReadString(const wchar_t* section, const wchar_t* key, const wchar_t* defaultValue) const
+{
+	wchar_t value[256];
+	GetPrivateProfileStringW(section, key, defaultValue, value, static_cast<DWORD>(std::size(value)), iniPath.c_str());
+	return value;
+}
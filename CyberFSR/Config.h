@@ -0,0 +1,45 @@
+#pragma once
+#include "pch.h"
+
+//Settings read from nvngx.ini next to the dll
+class Config
+{
+public:
+	//[Memory]
+	bool ShareTransientResources = false;
+
+	//[AsyncCompute]
+	bool AsyncComputeUpscale = false;
+
+	//[Benchmark]
+	bool BenchmarkEnabled = false;
+	unsigned int BenchmarkStartKey = 0;	//virtual key code, 0 starts right away
+	unsigned int BenchmarkStartDelayFrames = 0;
+	unsigned int BenchmarkSettleFrames = 600;
+	unsigned int BenchmarkWarmupFrames = 120;
+	unsigned int BenchmarkFramesPerStep = 600;
+	std::vector<float> BenchmarkCustomRatios;
+	std::wstring BenchmarkReportPath;
+
+	//[ReactiveMask]
+	bool ReactiveMaskEnabled = false;
+	float ReactiveMaskScale = 1.0f;
+	float ReactiveMaskCutoffThreshold = 0.2f;
+	float ReactiveMaskBinaryValue = 0.9f;
+
+	static Config& instance()
+	{
+		static Config INSTANCE;
+		return INSTANCE;
+	}
+
+private:
+	Config();
+
+	std::wstring iniPath;
+
+	bool ReadBool(const wchar_t* section, const wchar_t* key, bool defaultValue) const;
+	float ReadFloat(const wchar_t* section, const wchar_t* key, float defaultValue) const;
+	unsigned int ReadUInt(const wchar_t* section, const wchar_t* key, unsigned int defaultValue) const;
+	std::wstring ReadString(const wchar_t* section, const wchar_t* key, const wchar_t* defaultValue) const;
+};
@@ -1,22 +1,32 @@
 #include "pch.h"
 #include "CyberFsr.h"
 #include "DirectXHooks.h"
+#include "FsrInterfaceHooks.h"
+#include "SharedResources.h"
+#include "AsyncCompute.h"
+#include "QualitySweep.h"
+#include "Config.h"
 #include "Util.h"
+#include "CyberFsrExt.h"
+#include "Trace.h"
 
 NVSDK_NGX_Result NVSDK_NGX_D3D12_Init_Ext(unsigned long long InApplicationId, const wchar_t* InApplicationDataPath,
 	ID3D12Device* InDevice, const NVSDK_NGX_FeatureCommonInfo* InFeatureInfo, NVSDK_NGX_Version InSDKVersion,
 	unsigned long long unknown0)
 {
+	TRACE_ZONE("NVSDK_NGX_D3D12_Init_Ext");
 	return NVSDK_NGX_Result_Success;
 }
 
 NVSDK_NGX_Result NVSDK_NGX_D3D12_Init(unsigned long long InApplicationId, const wchar_t* InApplicationDataPath, ID3D12Device* InDevice, const NVSDK_NGX_FeatureCommonInfo* InFeatureInfo, NVSDK_NGX_Version InSDKVersion)
 {
+	TRACE_ZONE("NVSDK_NGX_D3D12_Init");
 	return NVSDK_NGX_D3D12_Init_Ext(InApplicationId, InApplicationDataPath, InDevice, InFeatureInfo, InSDKVersion, 0);
 }
 
 NVSDK_NGX_Result NVSDK_CONV NVSDK_NGX_D3D12_Shutdown(void)
 {
+	TRACE_ZONE("NVSDK_NGX_D3D12_Shutdown");
 	CyberFsrContext::instance().Parameters.clear();
 	CyberFsrContext::instance().Contexts.clear();
 	return NVSDK_NGX_Result_Success;
@@ -24,6 +34,7 @@ NVSDK_NGX_Result NVSDK_CONV NVSDK_NGX_D3D12_Shutdown(void)
 
 NVSDK_NGX_Result NVSDK_CONV NVSDK_NGX_D3D12_Shutdown1(ID3D12Device* InDevice)
 {
+	TRACE_ZONE("NVSDK_NGX_D3D12_Shutdown1");
 	CyberFsrContext::instance().Parameters.clear();
 	CyberFsrContext::instance().Contexts.clear();
 	return NVSDK_NGX_Result_Success;
@@ -32,6 +43,7 @@ NVSDK_NGX_Result NVSDK_CONV NVSDK_NGX_D3D12_Shutdown1(ID3D12Device* InDevice)
 //Deprecated Parameter Function - Internal Memory Tracking
 NVSDK_NGX_Result NVSDK_NGX_D3D12_GetParameters(NVSDK_NGX_Parameter** OutParameters)
 {
+	TRACE_ZONE("NVSDK_NGX_D3D12_GetParameters");
 	*OutParameters = CyberFsrContext::instance().AllocateParameter<Dx12ParameterImpl>();
 	return NVSDK_NGX_Result_Success;
 }
@@ -39,6 +51,7 @@ NVSDK_NGX_Result NVSDK_NGX_D3D12_GetParameters(NVSDK_NGX_Parameter** OutParamete
 //TODO External Memory Tracking
 NVSDK_NGX_Result NVSDK_NGX_D3D12_GetCapabilityParameters(NVSDK_NGX_Parameter** OutParameters)
 {
+	TRACE_ZONE("NVSDK_NGX_D3D12_GetCapabilityParameters");
 	*OutParameters = new Dx12ParameterImpl();
 	return NVSDK_NGX_Result_Success;
 }
@@ -46,6 +59,7 @@ NVSDK_NGX_Result NVSDK_NGX_D3D12_GetCapabilityParameters(NVSDK_NGX_Parameter** O
 //TODO
 NVSDK_NGX_Result NVSDK_NGX_D3D12_AllocateParameters(NVSDK_NGX_Parameter** OutParameters)
 {
+	TRACE_ZONE("NVSDK_NGX_D3D12_AllocateParameters");
 	*OutParameters = new Dx12ParameterImpl();
 	return NVSDK_NGX_Result_Success;
 }
@@ -53,6 +67,7 @@ NVSDK_NGX_Result NVSDK_NGX_D3D12_AllocateParameters(NVSDK_NGX_Parameter** OutPar
 //TODO
 NVSDK_NGX_Result NVSDK_NGX_D3D12_DestroyParameters(NVSDK_NGX_Parameter* InParameters)
 {
+	TRACE_ZONE("NVSDK_NGX_D3D12_DestroyParameters");
 	delete InParameters;
 	return NVSDK_NGX_Result_Success;
 }
@@ -61,6 +76,7 @@ NVSDK_NGX_Result NVSDK_NGX_D3D12_DestroyParameters(NVSDK_NGX_Parameter* InParame
 NVSDK_NGX_Result NVSDK_NGX_D3D12_GetScratchBufferSize(NVSDK_NGX_Feature InFeatureId,
 	const NVSDK_NGX_Parameter* InParameters, size_t* OutSizeInBytes)
 {
+	TRACE_ZONE("NVSDK_NGX_D3D12_GetScratchBufferSize");
 	return NVSDK_NGX_Result_Success;
 }
 
@@ -72,47 +88,106 @@ NVSDK_NGX_Result NVSDK_NGX_D3D12_CreateFeature(ID3D12GraphicsCommandList* InCmdL
 	ID3D12Device* device;
 	InCmdList->GetDevice(IID_PPV_ARGS(&device));
 	auto deviceContext = CyberFsrContext::instance().CreateContext();
+	TRACE_FEATURE_ZONE("NVSDK_NGX_D3D12_CreateFeature", deviceContext);
 	deviceContext->ViewMatrix = std::make_unique<ViewMatrixHook>();
+	deviceContext->DxDevice = device;
+	deviceContext->RenderWidth = inParams->Width;
+	deviceContext->RenderHeight = inParams->Height;
+	deviceContext->Hdr = inParams->Hdr;
 
 	*OutHandle = &deviceContext->Handle;
 
-	FfxFsr2ContextDescription initParams = {};
+	auto& initParams = deviceContext->ContextDescription;
 	const size_t scratchBufferSize = ffxFsr2GetScratchMemorySizeDX12();
 	void* scratchBuffer = malloc(scratchBufferSize);
 	FfxErrorCode errorCode = ffxFsr2GetInterfaceDX12(&initParams.callbacks, device, scratchBuffer, scratchBufferSize);
 	FFX_ASSERT(errorCode == FFX_OK);
+	deviceContext->ScratchBuffer = scratchBuffer;
+	HookFsrInterface(&initParams.callbacks);
+
+	if (Config::instance().ShareTransientResources || Config::instance().AsyncComputeUpscale)
+		HookCreateCommittedResource(device);
 
 	initParams.device = ffxGetDeviceDX12(device);
 	initParams.maxRenderSize.width = inParams->Width;
 	initParams.maxRenderSize.height = inParams->Height;
 	initParams.displaySize.width = inParams->OutWidth;
 	initParams.displaySize.height = inParams->OutHeight;
-	initParams.flags = (inParams->DepthInverted) ? FFX_FSR2_ENABLE_DEPTH_INVERTED : 0
-		| (inParams->AutoExposure) ? FFX_FSR2_ENABLE_AUTO_EXPOSURE : 0
-		| (inParams->Hdr) ? FFX_FSR2_ENABLE_HIGH_DYNAMIC_RANGE : 0
-		| (inParams->JitterMotion) ? FFX_FSR2_ENABLE_MOTION_VECTORS_JITTER_CANCELLATION : 0
-		| (!inParams->LowRes) ? FFX_FSR2_ENABLE_DISPLAY_RESOLUTION_MOTION_VECTORS : 0;
-
-	deviceContext->FsrContext = std::make_unique<FfxFsr2Context>();
-
-	ffxFsr2ContextCreate(deviceContext->FsrContext.get(), &initParams);
+	initParams.flags = 0;
+	if (inParams->DepthInverted)
+		initParams.flags |= FFX_FSR2_ENABLE_DEPTH_INVERTED;
+	if (inParams->Hdr)
+		initParams.flags |= FFX_FSR2_ENABLE_HIGH_DYNAMIC_RANGE;
+	if (inParams->JitterMotion)
+		initParams.flags |= FFX_FSR2_ENABLE_MOTION_VECTORS_JITTER_CANCELLATION;
+	if (!inParams->LowRes)
+		initParams.flags |= FFX_FSR2_ENABLE_DISPLAY_RESOLUTION_MOTION_VECTORS;
+
+	//FFX_FSR2_ENABLE_AUTO_EXPOSURE depends on the ExposureTexture of the first evaluation
+	deviceContext->Dispatch = FeatureDispatch(inParams->AutoExposure, Config::instance().ReactiveMaskEnabled);
 
 	HookSetComputeRootSignature(InCmdList);
 
 	return NVSDK_NGX_Result_Success;
 }
 
+QualitySweep& BenchmarkSweep()
+{
+	static QualitySweep INSTANCE = []()
+	{
+		const auto& config = Config::instance();
+		std::vector<QualitySweep::Step> steps;
+
+		if (config.BenchmarkEnabled)
+		{
+			steps = {
+				{ "UltraQuality", NVSDK_NGX_PerfQuality_Value_UltraQuality, 0.0f },
+				{ "MaxQuality", NVSDK_NGX_PerfQuality_Value_MaxQuality, 0.0f },
+				{ "Balanced", NVSDK_NGX_PerfQuality_Value_Balanced, 0.0f },
+				{ "MaxPerf", NVSDK_NGX_PerfQuality_Value_MaxPerf, 0.0f },
+				{ "UltraPerformance", NVSDK_NGX_PerfQuality_Value_UltraPerformance, 0.0f },
+			};
+
+			for (float ratio : config.BenchmarkCustomRatios)
+				steps.push_back({ "Custom", NVSDK_NGX_PerfQuality_Value_Balanced, ratio });
+		}
+
+		QualitySweep sweep(steps, { config.BenchmarkStartDelayFrames, config.BenchmarkSettleFrames, config.BenchmarkWarmupFrames, config.BenchmarkFramesPerStep });
+		if (config.BenchmarkStartKey == 0)
+			sweep.Start();
+
+		return sweep;
+	}();
+
+	return INSTANCE;
+}
+
+/*
+Like ffxFsr2ContextDestroy itself this frees the feature's resources right away, the generated reactive mask included, the engine has to release a feature only once the GPU is done with it.
+With async compute that also means the command lists it was evaluated into got submitted, until then its upscale waits in one of the shim's slots.
+*/
 NVSDK_NGX_Result NVSDK_NGX_D3D12_ReleaseFeature(NVSDK_NGX_Handle* InHandle)
 {
 	auto deviceContext = CyberFsrContext::instance().Contexts[InHandle->Id];
-	FfxErrorCode errorCode = ffxFsr2ContextDestroy(deviceContext->FsrContext.get());
-	FFX_ASSERT(errorCode == FFX_OK);
+	TRACE_FEATURE_ZONE("NVSDK_NGX_D3D12_ReleaseFeature", deviceContext);
+	if (deviceContext->Dispatch.ContextCreated())
+	{
+		TRACE_FEATURE_ZONE("ffxFsr2ContextDestroy", deviceContext);
+		FfxErrorCode errorCode = ffxFsr2ContextDestroy(deviceContext->FsrContext.get());
+		FFX_ASSERT(errorCode == FFX_OK);
+	}
+	SharedResourcePool::instance().ReleaseFeature(deviceContext);
+	BenchmarkSweep().OnFeatureReleased(InHandle->Id);
+	free(deviceContext->ScratchBuffer);
+	if (auto* reactiveMask = static_cast<ID3D12Resource*>(deviceContext->Dispatch.ReactiveMask()))
+		reactiveMask->Release();
 	CyberFsrContext::instance().DeleteContext(InHandle);
 	return NVSDK_NGX_Result_Success;
 }
 
-NVSDK_NGX_Result NVSDK_NGX_D3D12_EvaluateFeature(ID3D12GraphicsCommandList* InCmdList, const NVSDK_NGX_Handle* InFeatureHandle, const NVSDK_NGX_Parameter* InParameters, PFN_NVSDK_NGX_ProgressCallback InCallback)
+ID3D12RootSignature* GetEngineRootSignature(ID3D12GraphicsCommandList* InCmdList)
 {
+	TRACE_ZONE("RootSignature lookup");
 	ID3D12RootSignature* orgRootSig = nullptr;
 
 	rootSigMutex.lock();
@@ -126,13 +201,92 @@ NVSDK_NGX_Result NVSDK_NGX_D3D12_EvaluateFeature(ID3D12GraphicsCommandList* InCm
 	}
 	rootSigMutex.unlock();
 
-	ID3D12Device* device;
-	InCmdList->GetDevice(IID_PPV_ARGS(&device));
-	auto deviceContext = CyberFsrContext::instance().Contexts[InFeatureHandle->Id];
+	return orgRootSig;
+}
 
-	if (orgRootSig)
+//FeatureDispatch's calls for one evaluation, recorded into InCmdList
+class Fsr2DispatchCalls : public FeatureDispatchCalls
+{
+public:
+	Fsr2DispatchCalls(ID3D12GraphicsCommandList* InCmdList, FeatureContext* deviceContext, const Dx12ParameterImpl* inParams)
+		: InCmdList(InCmdList), deviceContext(deviceContext), inParams(inParams) {}
+
+	void CreateContext(bool autoExposure) override
 	{
-		const auto inParams = dynamic_cast<const Dx12ParameterImpl*>(InParameters);
+		auto initParams = deviceContext->ContextDescription;
+		if (autoExposure)
+			initParams.flags |= FFX_FSR2_ENABLE_AUTO_EXPOSURE;
+
+		deviceContext->FsrContext = std::make_unique<FfxFsr2Context>();
+
+		{
+			TRACE_FEATURE_ZONE("ffxFsr2ContextCreate", deviceContext);
+			ffxFsr2ContextCreate(deviceContext->FsrContext.get(), &initParams);
+		}
+
+		if (Config::instance().ShareTransientResources)
+			SharedResourcePool::instance().ReportMemory("created");
+	}
+
+	void* CreateReactiveMask() override
+	{
+		const auto& config = Config::instance();
+
+		D3D12_HEAP_PROPERTIES heapProperties = {};
+		heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+		D3D12_RESOURCE_DESC resourceDesc = {};
+		resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+		resourceDesc.Width = deviceContext->RenderWidth;
+		resourceDesc.Height = deviceContext->RenderHeight;
+		resourceDesc.DepthOrArraySize = 1;
+		resourceDesc.MipLevels = 1;
+		resourceDesc.Format = DXGI_FORMAT_R8_UNORM;
+		resourceDesc.SampleDesc.Count = 1;
+		resourceDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+		//the state FSR2 expects for FFX_RESOURCE_STATE_COMPUTE_READ
+		auto readState = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+		if (config.AsyncComputeUpscale)
+			readState = ComputeQueueState(readState);
+
+		ID3D12Resource* reactiveMask;
+		ThrowIfFailed(deviceContext->DxDevice->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc,
+			readState, nullptr, IID_PPV_ARGS(&reactiveMask)));
+		reactiveMask->SetName(L"CyberFSR_ReactiveMask");
+
+		return reactiveMask;
+	}
+
+	//the mask starts and ends each frame in the compute read state
+	void GenerateReactiveMask(void* reactiveMask) override
+	{
+		TRACE_FEATURE_ZONE("Generate reactive mask", deviceContext);
+
+		auto* fsrContext = deviceContext->FsrContext.get();
+		const auto& config = Config::instance();
+
+		FfxFsr2GenerateReactiveDescription reactiveParameters = {};
+		reactiveParameters.commandList = ffxGetCommandListDX12(InCmdList);
+		reactiveParameters.colorOpaqueOnly = ffxGetResourceDX12(fsrContext, inParams->ColorOpaqueOnly, (wchar_t*)L"FSR2_InputOpaqueOnly");
+		reactiveParameters.colorPreUpscale = ffxGetResourceDX12(fsrContext, inParams->Color, (wchar_t*)L"FSR2_InputColor");
+		reactiveParameters.outReactive = ffxGetResourceDX12(fsrContext, static_cast<ID3D12Resource*>(reactiveMask), (wchar_t*)L"FSR2_GeneratedReactiveMask");
+		reactiveParameters.renderSize.width = inParams->Width;
+		reactiveParameters.renderSize.height = inParams->Height;
+		reactiveParameters.scale = config.ReactiveMaskScale;
+		reactiveParameters.cutoffThreshold = config.ReactiveMaskCutoffThreshold;
+		reactiveParameters.binaryValue = config.ReactiveMaskBinaryValue;
+		reactiveParameters.flags = FFX_FSR2_AUTOREACTIVEFLAGS_APPLY_THRESHOLD | FFX_FSR2_AUTOREACTIVEFLAGS_USE_COMPONENTS_MAX;
+		if (deviceContext->Hdr)
+			reactiveParameters.flags |= FFX_FSR2_AUTOREACTIVEFLAGS_APPLY_TONEMAP;
+
+		FfxErrorCode errorCode = ffxFsr2ContextGenerateReactiveMask(fsrContext, &reactiveParameters);
+		FFX_ASSERT(errorCode == FFX_OK);
+	}
+
+	void Dispatch(void* reactiveMask) override
+	{
+		TRACE_FEATURE_ZONE("ffxFsr2ContextDispatch", deviceContext);
 
 		auto* fsrContext = deviceContext->FsrContext.get();
 
@@ -143,8 +297,11 @@ NVSDK_NGX_Result NVSDK_NGX_D3D12_EvaluateFeature(ID3D12GraphicsCommandList* InCm
 		dispatchParameters.motionVectors = ffxGetResourceDX12(fsrContext, inParams->MotionVectors, (wchar_t*)L"FSR2_InputMotionVectors");
 		dispatchParameters.exposure = ffxGetResourceDX12(fsrContext, inParams->ExposureTexture, (wchar_t*)L"FSR2_InputExposure");
 
-		//Not sure if these two actually work
-		dispatchParameters.reactive = ffxGetResourceDX12(fsrContext, inParams->InputBiasCurrentColorMask, (wchar_t*)L"FSR2_InputReactiveMap");
+		//Not sure if these two actually work, the generated mask is left in the unordered access state by its pass
+		if (reactiveMask)
+			dispatchParameters.reactive = ffxGetResourceDX12(fsrContext, static_cast<ID3D12Resource*>(reactiveMask), (wchar_t*)L"FSR2_InputReactiveMap", FFX_RESOURCE_STATE_UNORDERED_ACCESS);
+		else
+			dispatchParameters.reactive = ffxGetResourceDX12(fsrContext, inParams->InputBiasCurrentColorMask, (wchar_t*)L"FSR2_InputReactiveMap");
 		dispatchParameters.transparencyAndComposition = ffxGetResourceDX12(fsrContext, inParams->TransparencyMask, (wchar_t*)L"FSR2_TransparencyAndCompositionMap");
 
 		dispatchParameters.output = ffxGetResourceDX12(fsrContext, inParams->Output, (wchar_t*)L"FSR2_OutputUpscaledColor", FFX_RESOURCE_STATE_UNORDERED_ACCESS);
@@ -166,7 +323,7 @@ NVSDK_NGX_Result NVSDK_NGX_D3D12_EvaluateFeature(ID3D12GraphicsCommandList* InCm
 		lastFrameTime = currentTime;
 
 		dispatchParameters.frameTimeDelta = (float)deltaTime;
-		dispatchParameters.preExposure = 1.0f;
+		dispatchParameters.preExposure = inParams->PreExposure;
 		dispatchParameters.renderSize.width = inParams->Width;
 		dispatchParameters.renderSize.height = inParams->Height;
 
@@ -174,10 +331,142 @@ NVSDK_NGX_Result NVSDK_NGX_D3D12_EvaluateFeature(ID3D12GraphicsCommandList* InCm
 		dispatchParameters.cameraFar = deviceContext->ViewMatrix->GetFarPlane();
 		dispatchParameters.cameraNear = deviceContext->ViewMatrix->GetNearPlane();
 		dispatchParameters.cameraFovAngleVertical = DirectX::XMConvertToRadians(deviceContext->ViewMatrix->GetFov());
+
 		FfxErrorCode errorCode = ffxFsr2ContextDispatch(fsrContext, &dispatchParameters);
 		FFX_ASSERT(errorCode == FFX_OK);
+	}
+
+private:
+	ID3D12GraphicsCommandList* InCmdList;
+	FeatureContext* deviceContext;
+	const Dx12ParameterImpl* inParams;
+};
 
-		InCmdList->SetComputeRootSignature(orgRootSig);
+void DispatchFsr2(ID3D12GraphicsCommandList* InCmdList, FeatureContext* deviceContext, const Dx12ParameterImpl* inParams)
+{
+	FeatureInputs inputs;
+	inputs.ExposureBound = inParams->ExposureTexture != nullptr;
+	inputs.ReactiveMaskBound = inParams->InputBiasCurrentColorMask != nullptr;
+	inputs.OpaqueColorBound = inParams->ColorOpaqueOnly != nullptr;
+
+	Fsr2DispatchCalls calls(InCmdList, deviceContext, inParams);
+	deviceContext->Dispatch.Evaluate(inputs, calls);
+}
+
+void RecordBenchmarkFrame(double evaluateStart, unsigned int feature, const Dx12ParameterImpl* inParams)
+{
+	auto& sweep = BenchmarkSweep();
+	const auto& config = Config::instance();
+
+	//one evaluation of the followed feature is one frame
+	if (!config.BenchmarkEnabled || !sweep.Follows(feature))
+		return;
+
+	if (!sweep.Started() && (GetAsyncKeyState(config.BenchmarkStartKey) & 0x8000))
+	{
+		sweep.Start();
+		printf("Benchmark started, the game has to query the DLSS optimal settings again to follow each step\n");
+	}
+
+	if (!sweep.Active())
+		return;
+
+	static double lastFrameTime;
+	const double currentTime = Util::MillisecondsNow();
+	const double frameTime = lastFrameTime ? currentTime - lastFrameTime : 0.0;
+	lastFrameTime = currentTime;
+
+	if (sweep.OnFrame(frameTime, currentTime - evaluateStart, inParams->Width, inParams->Height))
+	{
+		const auto& reportPath = config.BenchmarkReportPath;
+		if (sweep.WriteReport(reportPath))
+			printf("Benchmark finished, report written to %ls.csv/.json\n", reportPath.c_str());
+		else
+			printf("Benchmark finished, couldn't write the report to %ls\n", reportPath.c_str());
+	}
+}
+
+NVSDK_NGX_Result NVSDK_NGX_D3D12_EvaluateFeature(ID3D12GraphicsCommandList* InCmdList, const NVSDK_NGX_Handle* InFeatureHandle, const NVSDK_NGX_Parameter* InParameters, PFN_NVSDK_NGX_ProgressCallback InCallback)
+{
+	const double evaluateStart = Util::MillisecondsNow();
+	auto deviceContext = CyberFsrContext::instance().Contexts[InFeatureHandle->Id];
+	deviceContext->FrameIndex++;
+	TRACE_FEATURE_ZONE("NVSDK_NGX_D3D12_EvaluateFeature", deviceContext);
+
+	const bool asyncCompute = Config::instance().AsyncComputeUpscale;
+	ID3D12RootSignature* orgRootSig = asyncCompute ? nullptr : GetEngineRootSignature(InCmdList);
+
+	if (asyncCompute || orgRootSig)
+	{
+		const auto inParams = dynamic_cast<const Dx12ParameterImpl*>(InParameters);
+
+		//on the shim's compute queue the engine command list stays untouched
+		auto* fsrCmdList = asyncCompute ? AsyncCompute::instance().Begin(InCmdList) : InCmdList;
+		if (fsrCmdList == nullptr)
+			return NVSDK_NGX_Result_Fail;
+
+		SharedResourcePool::instance().BeginAccess(deviceContext, fsrCmdList);
+
+		DispatchFsr2(fsrCmdList, deviceContext, inParams);
+		inParams->RecordSetBatch(deviceContext->Handle.Id, deviceContext->FrameIndex);
+
+		if (orgRootSig)
+			InCmdList->SetComputeRootSignature(orgRootSig);
+
+		RecordBenchmarkFrame(evaluateStart, InFeatureHandle->Id, inParams);
+	}
+
+	myCommandList = InCmdList;
+
+	return NVSDK_NGX_Result_Success;
+}
+
+/*
+Split screen, scopes and planar reflections upscale several views per frame.
+All views record their FSR2 passes through the regular dispatch but the jobs are held back in the interface hooks, afterwards the same passes of all views get executed back to back.
+Contexts created by a batched evaluation with the same flags share the pipeline of every pass, so consecutive jobs of the same pass skip the redundant root signature and pipeline binds.
+The engine root signature gets looked up and restored once for the whole batch.
+*/
+NVSDK_NGX_Result NVSDK_CONV CyberFSR_D3D12_EvaluateFeatures(ID3D12GraphicsCommandList* InCmdList, const NVSDK_NGX_Handle* const* InFeatureHandles,
+	const NVSDK_NGX_Parameter* const* InParameters, unsigned int InFeatureCount)
+{
+	TRACE_ZONE("CyberFSR_D3D12_EvaluateFeatures");
+	const double evaluateStart = Util::MillisecondsNow();
+	HookSetPipelineState(InCmdList);
+
+	const bool asyncCompute = Config::instance().AsyncComputeUpscale;
+	ID3D12RootSignature* orgRootSig = asyncCompute ? nullptr : GetEngineRootSignature(InCmdList);
+
+	if (asyncCompute || orgRootSig)
+	{
+		auto* fsrCmdList = asyncCompute ? AsyncCompute::instance().Begin(InCmdList) : InCmdList;
+		if (fsrCmdList == nullptr)
+			return NVSDK_NGX_Result_Fail;
+
+		std::vector<FeatureContext*> features;
+		features.reserve(InFeatureCount);
+
+		for (unsigned int i = 0; i < InFeatureCount; i++)
+		{
+			auto deviceContext = CyberFsrContext::instance().Contexts[InFeatureHandles[i]->Id];
+			const auto inParams = dynamic_cast<const Dx12ParameterImpl*>(InParameters[i]);
+
+			deviceContext->FrameIndex++;
+			deviceContext->DeferJobs = true;
+			DispatchFsr2(fsrCmdList, deviceContext, inParams);
+			inParams->RecordSetBatch(deviceContext->Handle.Id, deviceContext->FrameIndex);
+			features.push_back(deviceContext);
+		}
+
+		//aliased transient resources can't be in flight for two views at once
+		ExecuteDeferredJobs(features, fsrCmdList, !Config::instance().ShareTransientResources);
+
+		if (orgRootSig)
+			InCmdList->SetComputeRootSignature(orgRootSig);
+
+		//one batch is one frame, the first view is the one the quality mode applies to
+		if (InFeatureCount)
+			RecordBenchmarkFrame(evaluateStart, InFeatureHandles[0]->Id, dynamic_cast<const Dx12ParameterImpl*>(InParameters[0]));
 	}
 
 	myCommandList = InCmdList;
@@ -185,10 +474,43 @@ NVSDK_NGX_Result NVSDK_NGX_D3D12_EvaluateFeature(ID3D12GraphicsCommandList* InCm
 	return NVSDK_NGX_Result_Success;
 }
 
+NVSDK_NGX_Result NVSDK_CONV CyberFSR_D3D12_GetAsyncComputeFence(ID3D12GraphicsCommandList* InCmdList, ID3D12Fence** OutFence, unsigned long long* OutValue)
+{
+	TRACE_ZONE("CyberFSR_D3D12_GetAsyncComputeFence");
+	if (!Config::instance().AsyncComputeUpscale || !AsyncCompute::instance().TakeFence(InCmdList, OutFence, OutValue))
+		return NVSDK_NGX_Result_Fail;
+
+	return NVSDK_NGX_Result_Success;
+}
+
+NVSDK_NGX_Result NVSDK_CONV CyberFSR_WriteTrace(const wchar_t* InPath)
+{
+#if CYBERFSR_TRACE
+	if (Trace::WriteChromeTrace(InPath))
+		return NVSDK_NGX_Result_Success;
+#endif
+
+	return NVSDK_NGX_Result_Fail;
+}
+
 NVSDK_NGX_Result NVSDK_CONV NVSDK_NGX_DLSS_GetOptimalSettingsCallback(NVSDK_NGX_Parameter* InParams)
 {
+	TRACE_ZONE("NVSDK_NGX_DLSS_GetOptimalSettingsCallback");
 	auto* params = (Dx12ParameterImpl*)InParams;
-	params->EvaluateRenderScale();
+
+	auto& sweep = BenchmarkSweep();
+	if (sweep.Active() && sweep.CurrentStep().UpscaleRatio > 0.0f)
+		params->EvaluateRenderScale(sweep.CurrentStep().UpscaleRatio);
+	else
+	{
+		if (sweep.Active())
+			params->PerfQualityValue = static_cast<NVSDK_NGX_PerfQuality_Value>(sweep.CurrentStep().PerfQualityValue);
+
+		params->EvaluateRenderScale();
+	}
+
+	sweep.OnOptimalSettings(params->OutWidth, params->OutHeight);
+
 	return NVSDK_NGX_Result_Success;
 }
 
@@ -207,6 +529,14 @@ FeatureContext* CyberFsrContext::CreateContext()
 	return dCtx;
 }
 
+FeatureContext* CyberFsrContext::GetContext(const FfxFsr2Interface* callbacks)
+{
+	auto it = std::find_if(Contexts.begin(), Contexts.end(),
+		[callbacks](const auto& p) { return p.second->ScratchBuffer == callbacks->scratchBuffer; });
+
+	return it != Contexts.end() ? it->second : nullptr;
+}
+
 void CyberFsrContext::DeleteContext(NVSDK_NGX_Handle* handle)
 {
 	auto handleId = handle->Id;
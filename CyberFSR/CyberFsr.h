@@ -2,6 +2,7 @@
 #include "pch.h"
 #include "ViewMatrixHook.h"
 #include "Dx12ParameterImpl.h"
+#include "FeatureDispatch.h"
 
 class FeatureContext;
 
@@ -16,6 +17,7 @@ public:
 	std::unordered_map <unsigned int, FeatureContext*> Contexts;
 	FeatureContext* CreateContext();
 	void DeleteContext(NVSDK_NGX_Handle* handle);
+	FeatureContext* GetContext(const FfxFsr2Interface* callbacks);
 
 	static CyberFsrContext& instance()
 	{
@@ -34,12 +36,25 @@ public:
 	NVSDK_NGX_Handle Handle;
 	ID3D12Device* DxDevice;
 	std::unique_ptr<FfxFsr2Context> FsrContext;
+	//filled by CreateFeature, the context itself gets created by the first evaluation
+	FfxFsr2ContextDescription ContextDescription{};
+	FeatureDispatch Dispatch;
+	void* ScratchBuffer = nullptr;
+
+	//jobs held back by the interface hooks while the feature is part of a batched evaluation
+	bool DeferJobs = false;
+	FfxFsr2Interface* BackendInterface = nullptr;
+	std::vector<FfxGpuJobDescription> DeferredJobs;
 
 	unsigned int Width{}, Height{}, RenderWidth{}, RenderHeight{};
 	NVSDK_NGX_PerfQuality_Value PerfQualityValue = NVSDK_NGX_PerfQuality_Value_Balanced;
 	float Sharpness = 1.0f;
 	float MVScaleX{}, MVScaleY{};
 	float JitterOffsetX{}, JitterOffsetY{};
+
+	bool Hdr{};
+
+	unsigned long long FrameIndex{};
 };
 
 template<class T>
@@ -0,0 +1,61 @@
+#pragma once
+
+/*
+Extensions on top of the NGX entry points for integrations we control.
+Exports are resolved with GetProcAddress on nvngx.dll, games that don't know about them keep using the regular NGX calls.
+*/
+
+//Evaluates several features recorded into the same command list, InFeatureHandles and InParameters hold InFeatureCount entries
+NVSDK_NGX_API NVSDK_NGX_Result NVSDK_CONV CyberFSR_D3D12_EvaluateFeatures(ID3D12GraphicsCommandList* InCmdList, const NVSDK_NGX_Handle* const* InFeatureHandles,
+	const NVSDK_NGX_Parameter* const* InParameters, unsigned int InFeatureCount);
+typedef NVSDK_NGX_Result(NVSDK_CONV* PFN_CyberFSR_D3D12_EvaluateFeatures)(ID3D12GraphicsCommandList* InCmdList, const NVSDK_NGX_Handle* const* InFeatureHandles,
+	const NVSDK_NGX_Parameter* const* InParameters, unsigned int InFeatureCount);
+
+/*
+With [AsyncCompute] Enabled=1 the upscale runs on the shim's compute queue and by default the rest of the engine submission waits for it.
+Call this after evaluating into InCmdList and before submitting it to wait on OutFence for OutValue yourself, right before the output is consumed.
+*/
+NVSDK_NGX_API NVSDK_NGX_Result NVSDK_CONV CyberFSR_D3D12_GetAsyncComputeFence(ID3D12GraphicsCommandList* InCmdList, ID3D12Fence** OutFence, unsigned long long* OutValue);
+typedef NVSDK_NGX_Result(NVSDK_CONV* PFN_CyberFSR_D3D12_GetAsyncComputeFence)(ID3D12GraphicsCommandList* InCmdList, ID3D12Fence** OutFence, unsigned long long* OutValue);
+
+//Writes the recorded trace zones as Chrome trace_event JSON, fails if the dll was built without CYBERFSR_TRACE
+NVSDK_NGX_API NVSDK_NGX_Result NVSDK_CONV CyberFSR_WriteTrace(const wchar_t* InPath);
+typedef NVSDK_NGX_Result(NVSDK_CONV* PFN_CyberFSR_WriteTrace)(const wchar_t* InPath);
+
+/*
+Per frame state in one versioned block instead of a virtual Set per key.
+Resolve the setter through NVSDK_NGX_Parameter::Get("CyberFSR.SetFrameParameters", (void**)&setter) like DLSSOptimalSettingsCallback.
+Fields keep the meaning of their NGX keys, Sharpness stays in the DLSS range of [-0.99, 1].
+Blocks built against an older version pass a smaller Size, the fields appended after it keep their current values.
+*/
+#define CYBERFSR_FRAME_PARAMETERS_VERSION 3
+
+struct CyberFsrFrameParameters
+{
+	unsigned int Version;	//CYBERFSR_FRAME_PARAMETERS_VERSION
+	unsigned int Size;		//sizeof(CyberFsrFrameParameters)
+
+	ID3D12Resource* Color;
+	ID3D12Resource* Depth;
+	ID3D12Resource* MotionVectors;
+	ID3D12Resource* Output;
+	ID3D12Resource* ExposureTexture;
+	ID3D12Resource* TransparencyMask;
+	ID3D12Resource* InputBiasCurrentColorMask;
+
+	float JitterOffsetX, JitterOffsetY;
+	float MVScaleX, MVScaleY;
+	int Reset;
+	float Sharpness;
+
+	//DLSS.Render.Subrect.Dimensions, 0 keeps the current render size
+	unsigned int RenderSubrectWidth, RenderSubrectHeight;
+
+	//Version 2, DLSS.Pre.Exposure
+	float PreExposure;
+
+	//Version 3, CyberFSR.Color.Opaque.Only
+	ID3D12Resource* ColorOpaqueOnly;
+};
+
+typedef NVSDK_NGX_Result(NVSDK_CONV* PFN_CyberFSR_SetFrameParameters)(NVSDK_NGX_Parameter* InParameters, const CyberFsrFrameParameters* InFrameParameters);
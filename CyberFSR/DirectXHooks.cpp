@@ -1,6 +1,8 @@
 #include "pch.h"
 #include "Util.h"
 #include "DirectXHooks.h"
+#include "SharedResources.h"
+#include "AsyncCompute.h"
 
 /*
 Cyberpunk doesn't reset the ComputeRootSignature after running DLSS.
@@ -12,19 +14,50 @@ This allows us to keep track of every ComputeRootSignature and match the RootSig
 
 SETCOMPUTEROOTSIGNATURE oSetComputeRootSignature = nullptr;
 
+SETPIPELINESTATE oSetPipelineState = nullptr;
+
+RESOURCEBARRIER oResourceBarrier = nullptr;
+
+EXECUTECOMMANDLISTS oExecuteCommandLists = nullptr;
+
+CREATECOMMITTEDRESOURCE oCreateCommittedResource = nullptr;
+
 ID3D12CommandList* myCommandList = nullptr;
 
 std::unordered_map<ID3D12GraphicsCommandList*, ID3D12RootSignature*> commandListVector;
 
 std::mutex rootSigMutex;
 
+thread_local bool createForComputeQueue = false;
+
+//the shim's compute lists, one per async compute slot, added under the scheduler's lock and never removed
+std::atomic<ID3D12GraphicsCommandList*> computeLists[AsyncComputeScheduler::MaxSlots] = {};
+
+std::atomic<unsigned int> computeListCount{};
+
+bool IsComputeList(ID3D12GraphicsCommandList* commandList)
+{
+	const auto count = computeListCount.load(std::memory_order_acquire);
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		if (computeLists[i].load(std::memory_order_relaxed) == commandList)
+			return true;
+	}
+
+	return false;
+}
+
 void hSetComputeRootSignature(ID3D12GraphicsCommandList* commandList, ID3D12RootSignature* pRootSignature)
 {
-	rootSigMutex.lock();
-	commandListVector[commandList] = pRootSignature;
-	rootSigMutex.unlock();
+	BatchedSetComputeRootSignature(commandList, pRootSignature, [](ID3D12GraphicsCommandList* commandList, ID3D12RootSignature* pRootSignature)
+	{
+		rootSigMutex.lock();
+		commandListVector[commandList] = pRootSignature;
+		rootSigMutex.unlock();
 
-	return oSetComputeRootSignature(commandList, pRootSignature);
+		oSetComputeRootSignature(commandList, pRootSignature);
+	});
 }
 
 void HookSetComputeRootSignature(ID3D12GraphicsCommandList* InCmdList)
@@ -42,4 +75,156 @@ void HookSetComputeRootSignature(ID3D12GraphicsCommandList* InCmdList)
 		*computeRootSigFuncVTable = &hSetComputeRootSignature;
 		VirtualProtect(computeRootSigFuncVTable, sizeof(void*), oldProtect, nullptr);
 	}
-}
\ No newline at end of file
+}
+
+void hSetPipelineState(ID3D12GraphicsCommandList* commandList, ID3D12PipelineState* pPipelineState)
+{
+	BatchedSetPipelineState(commandList, pPipelineState, oSetPipelineState);
+}
+
+void HookSetPipelineState(ID3D12GraphicsCommandList* InCmdList)
+{
+	constexpr int offset = 0xC8 / sizeof(void*);
+
+	void** cmdListVTable = *reinterpret_cast<void***>(InCmdList);
+	const auto pipelineStateFuncVTable = reinterpret_cast<SETPIPELINESTATE*>(cmdListVTable + offset);
+
+	if (oSetPipelineState == nullptr)
+	{
+		oSetPipelineState = *pipelineStateFuncVTable;
+		DWORD oldProtect;
+		VirtualProtect(pipelineStateFuncVTable, sizeof(void*), PAGE_READWRITE, &oldProtect);
+		*pipelineStateFuncVTable = &hSetPipelineState;
+		VirtualProtect(pipelineStateFuncVTable, sizeof(void*), oldProtect, nullptr);
+	}
+}
+
+D3D12_RESOURCE_STATES ComputeQueueState(D3D12_RESOURCE_STATES state)
+{
+	const auto computeQueueStates = D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER | D3D12_RESOURCE_STATE_UNORDERED_ACCESS | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE
+		| D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT | D3D12_RESOURCE_STATE_COPY_DEST | D3D12_RESOURCE_STATE_COPY_SOURCE;
+
+	return state & computeQueueStates;
+}
+
+/*
+The FSR2 DX12 backend maps FFX_RESOURCE_STATE_COMPUTE_READ to NON_PIXEL_SHADER_RESOURCE | PIXEL_SHADER_RESOURCE, which isn't a legal barrier state on a compute list.
+Its internal resources get created in the translated state as well (see hCreateCommittedResource), so dropping the pixel shader bit on both sides keeps every transition consistent.
+The engine's lists share the vtable and pass through untouched.
+*/
+void hResourceBarrier(ID3D12GraphicsCommandList* commandList, UINT NumBarriers, const D3D12_RESOURCE_BARRIER* pBarriers)
+{
+	if (!IsComputeList(commandList))
+		return oResourceBarrier(commandList, NumBarriers, pBarriers);
+
+	D3D12_RESOURCE_BARRIER barriers[64];
+	UINT count = 0;
+
+	for (UINT i = 0; i < NumBarriers; i++)
+	{
+		auto barrier = pBarriers[i];
+
+		if (barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION)
+		{
+			barrier.Transition.StateBefore = ComputeQueueState(barrier.Transition.StateBefore);
+			barrier.Transition.StateAfter = ComputeQueueState(barrier.Transition.StateAfter);
+
+			if (barrier.Transition.StateBefore == barrier.Transition.StateAfter)
+				continue;
+		}
+
+		barriers[count++] = barrier;
+
+		if (count == std::size(barriers))
+		{
+			oResourceBarrier(commandList, count, barriers);
+			count = 0;
+		}
+	}
+
+	if (count)
+		oResourceBarrier(commandList, count, barriers);
+}
+
+void HookComputeCommandList(ID3D12GraphicsCommandList* InCmdList)
+{
+	constexpr int offset = 0xD0 / sizeof(void*);
+
+	void** cmdListVTable = *reinterpret_cast<void***>(InCmdList);
+	const auto resourceBarrierFuncVTable = reinterpret_cast<RESOURCEBARRIER*>(cmdListVTable + offset);
+
+	if (oResourceBarrier == nullptr)
+	{
+		oResourceBarrier = *resourceBarrierFuncVTable;
+		DWORD oldProtect;
+		VirtualProtect(resourceBarrierFuncVTable, sizeof(void*), PAGE_READWRITE, &oldProtect);
+		*resourceBarrierFuncVTable = &hResourceBarrier;
+		VirtualProtect(resourceBarrierFuncVTable, sizeof(void*), oldProtect, nullptr);
+	}
+
+	const auto index = computeListCount.load(std::memory_order_relaxed);
+	computeLists[index].store(InCmdList, std::memory_order_relaxed);
+	computeListCount.store(index + 1, std::memory_order_release);
+}
+
+void hExecuteCommandLists(ID3D12CommandQueue* commandQueue, UINT NumCommandLists, ID3D12CommandList* const* ppCommandLists)
+{
+	AsyncCompute::instance().Submit(commandQueue, NumCommandLists, ppCommandLists);
+}
+
+void HookExecuteCommandLists(ID3D12CommandQueue* InCommandQueue)
+{
+	constexpr int offset = 0x50 / sizeof(void*);
+
+	void** queueVTable = *reinterpret_cast<void***>(InCommandQueue);
+	const auto executeCommandListsFuncVTable = reinterpret_cast<EXECUTECOMMANDLISTS*>(queueVTable + offset);
+
+	if (oExecuteCommandLists == nullptr)
+	{
+		oExecuteCommandLists = *executeCommandListsFuncVTable;
+		DWORD oldProtect;
+		VirtualProtect(executeCommandListsFuncVTable, sizeof(void*), PAGE_READWRITE, &oldProtect);
+		*executeCommandListsFuncVTable = &hExecuteCommandLists;
+		VirtualProtect(executeCommandListsFuncVTable, sizeof(void*), oldProtect, nullptr);
+	}
+}
+
+/*
+The FSR2 DX12 backend allocates every internal resource with CreateCommittedResource.
+While a resource is created through the FfxFsr2Interface the SharedResourcePool can redirect the allocation into a shared heap and async compute moves its initial state to one the compute queue supports,
+every other call passes straight through.
+*/
+HRESULT hCreateCommittedResource(ID3D12Device* device, const D3D12_HEAP_PROPERTIES* pHeapProperties, D3D12_HEAP_FLAGS HeapFlags,
+	const D3D12_RESOURCE_DESC* pDesc, D3D12_RESOURCE_STATES InitialResourceState, const D3D12_CLEAR_VALUE* pOptimizedClearValue, REFIID riidResource, void** ppvResource)
+{
+	auto& pool = SharedResourcePool::instance();
+
+	//upload buffers have to stay in GENERIC_READ, they are only ever a copy source
+	if (createForComputeQueue && pHeapProperties->Type == D3D12_HEAP_TYPE_DEFAULT)
+		InitialResourceState = ComputeQueueState(InitialResourceState);
+
+	if (pool.HasPendingCreate())
+	{
+		if (auto* heap = pool.PlaceResource(device, pHeapProperties, pDesc))
+			return device->CreatePlacedResource(heap, 0, pDesc, InitialResourceState, pOptimizedClearValue, riidResource, ppvResource);
+	}
+
+	return oCreateCommittedResource(device, pHeapProperties, HeapFlags, pDesc, InitialResourceState, pOptimizedClearValue, riidResource, ppvResource);
+}
+
+void HookCreateCommittedResource(ID3D12Device* InDevice)
+{
+	constexpr int offset = 0xD8 / sizeof(void*);
+
+	void** deviceVTable = *reinterpret_cast<void***>(InDevice);
+	const auto createCommittedResourceFuncVTable = reinterpret_cast<CREATECOMMITTEDRESOURCE*>(deviceVTable + offset);
+
+	if (oCreateCommittedResource == nullptr)
+	{
+		oCreateCommittedResource = *createCommittedResourceFuncVTable;
+		DWORD oldProtect;
+		VirtualProtect(createCommittedResourceFuncVTable, sizeof(void*), PAGE_READWRITE, &oldProtect);
+		*createCommittedResourceFuncVTable = &hCreateCommittedResource;
+		VirtualProtect(createCommittedResourceFuncVTable, sizeof(void*), oldProtect, nullptr);
+	}
+}
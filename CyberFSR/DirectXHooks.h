@@ -1,12 +1,40 @@
 #pragma once
 #include "pch.h"
+#include "BatchSchedule.h"
 
 typedef void(__fastcall* SETCOMPUTEROOTSIGNATURE)(ID3D12GraphicsCommandList* commandList, ID3D12RootSignature* pRootSignature);
 
+typedef void(__fastcall* SETPIPELINESTATE)(ID3D12GraphicsCommandList* commandList, ID3D12PipelineState* pPipelineState);
+
+typedef void(__fastcall* RESOURCEBARRIER)(ID3D12GraphicsCommandList* commandList, UINT NumBarriers, const D3D12_RESOURCE_BARRIER* pBarriers);
+
+typedef void(__fastcall* EXECUTECOMMANDLISTS)(ID3D12CommandQueue* commandQueue, UINT NumCommandLists, ID3D12CommandList* const* ppCommandLists);
+
+typedef HRESULT(__fastcall* CREATECOMMITTEDRESOURCE)(ID3D12Device* device, const D3D12_HEAP_PROPERTIES* pHeapProperties, D3D12_HEAP_FLAGS HeapFlags,
+	const D3D12_RESOURCE_DESC* pDesc, D3D12_RESOURCE_STATES InitialResourceState, const D3D12_CLEAR_VALUE* pOptimizedClearValue, REFIID riidResource, void** ppvResource);
+
 extern ID3D12CommandList* myCommandList;
 
+extern EXECUTECOMMANDLISTS oExecuteCommandLists;
+
 extern std::unordered_map<ID3D12GraphicsCommandList*, ID3D12RootSignature*> commandListVector;
 
 extern std::mutex rootSigMutex;
 
+//set while the FSR2 backend creates a resource that only the async compute queue uses
+extern thread_local bool createForComputeQueue;
+
+//drops the states a compute queue doesn't support, PIXEL_SHADER_RESOURCE in particular
+D3D12_RESOURCE_STATES ComputeQueueState(D3D12_RESOURCE_STATES state);
+
 void HookSetComputeRootSignature(ID3D12GraphicsCommandList* InCmdList);
+
+//only needed to skip redundant binds in batched evaluations, installed by the first one
+void HookSetPipelineState(ID3D12GraphicsCommandList* InCmdList);
+
+void HookExecuteCommandLists(ID3D12CommandQueue* InCommandQueue);
+
+//ResourceBarrier translates states with ComputeQueueState on the compute command lists of the shim registered here, one per async compute slot
+void HookComputeCommandList(ID3D12GraphicsCommandList* InCmdList);
+
+void HookCreateCommittedResource(ID3D12Device* InDevice);
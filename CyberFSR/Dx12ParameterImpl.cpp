@@ -2,6 +2,29 @@
 #include "Util.h"
 #include "Dx12ParameterImpl.h"
 
+#if CYBERFSR_TRACE
+//stretches the parameter batch zone over one Set call
+struct SetBatchScope
+{
+	Trace::Event& batch;
+
+	SetBatchScope(Trace::Event& batch) : batch(batch)
+	{
+		if (batch.Count++ == 0)
+			batch.Start = Util::MillisecondsNow();
+	}
+
+	~SetBatchScope()
+	{
+		batch.Duration = Util::MillisecondsNow() - batch.Start;
+	}
+};
+
+#define TRACE_SET_BATCH() SetBatchScope setBatchScope(setBatch)
+#else
+#define TRACE_SET_BATCH()
+#endif
+
 void Dx12ParameterImpl::Set(const char* InName, unsigned long long InValue)
 {
 	//TODO
@@ -9,6 +32,8 @@ void Dx12ParameterImpl::Set(const char* InName, unsigned long long InValue)
 
 void Dx12ParameterImpl::Set(const char* InName, float InValue)
 {
+	TRACE_SET_BATCH();
+
 	switch (Util::NvParameterToEnum(InName))
 	{
 	case Util::NvParameter::MV_Scale_X:
@@ -24,13 +49,10 @@ void Dx12ParameterImpl::Set(const char* InName, float InValue)
 		JitterOffsetY = InValue;
 		break;
 	case Util::NvParameter::Sharpness:
-		// normalize sharpness value to [0, 1] range
-		// originally in range [-0.99, 1]
-		if (InValue >= 1.0f) {
-			Sharpness = 1;
-		} else {
-			Sharpness = (InValue + 0.99f) / 2.0f;
-		}
+		SetSharpness(InValue);
+		break;
+	case Util::NvParameter::Pre_Exposure:
+		PreExposure = InValue;
 		break;
 	}
 }
@@ -47,6 +69,8 @@ void Dx12ParameterImpl::Set(const char* InName, unsigned int InValue)
 
 void Dx12ParameterImpl::Set(const char* InName, int InValue)
 {
+	TRACE_SET_BATCH();
+
 	switch (Util::NvParameterToEnum(InName))
 	{
 	case Util::NvParameter::Width:
@@ -82,6 +106,7 @@ void Dx12ParameterImpl::Set(const char* InName, int InValue)
 		DepthInverted = InValue & NVSDK_NGX_DLSS_Feature_Flags_DepthInverted;
 		JitterMotion = InValue & NVSDK_NGX_DLSS_Feature_Flags_MVJittered;
 		LowRes = InValue & NVSDK_NGX_DLSS_Feature_Flags_MVLowRes;
+		AutoExposure = InValue & NVSDK_NGX_DLSS_Feature_Flags_AutoExposure;
 		//thats all for now
 		break;
 	}
@@ -94,6 +119,8 @@ void Dx12ParameterImpl::Set(const char* InName, ID3D11Resource* InValue)
 
 void Dx12ParameterImpl::Set(const char* InName, ID3D12Resource* InValue)
 {
+	TRACE_SET_BATCH();
+
 	switch (Util::NvParameterToEnum(InName))
 	{
 	case Util::NvParameter::DLSS_Input_Bias_Current_Color_Mask:
@@ -131,6 +158,11 @@ void Dx12ParameterImpl::Set(const char* InName, ID3D12Resource* InValue)
 		if (InValue)
 			ExposureTexture->SetName(L"ExposureTexture");
 		break;
+	case Util::NvParameter::CyberFSR_Color_Opaque_Only:
+		ColorOpaqueOnly = InValue;
+		if (InValue)
+			ColorOpaqueOnly->SetName(L"ColorOpaqueOnly");
+		break;
 	}
 }
 
@@ -151,6 +183,9 @@ NVSDK_NGX_Result Dx12ParameterImpl::Get(const char* InName, float* OutValue) con
 	case Util::NvParameter::Sharpness:
 		*OutValue = Sharpness;
 		break;
+	case Util::NvParameter::Pre_Exposure:
+		*OutValue = PreExposure;
+		break;
 	default:
 		*OutValue = 0.0f;
 		return NVSDK_NGX_Result_FAIL_InvalidParameter;
@@ -229,6 +264,7 @@ NVSDK_NGX_Result Dx12ParameterImpl::Get(const char* InName, ID3D12Resource** Out
 }
 
 NVSDK_NGX_Result NVSDK_CONV NVSDK_NGX_DLSS_GetOptimalSettingsCallback(NVSDK_NGX_Parameter* InParams);
+NVSDK_NGX_Result NVSDK_CONV CyberFSR_SetFrameParameters(NVSDK_NGX_Parameter* InParameters, const CyberFsrFrameParameters* InFrameParameters);
 
 NVSDK_NGX_Result Dx12ParameterImpl::Get(const char* InName, void** OutValue) const
 {
@@ -237,6 +273,9 @@ NVSDK_NGX_Result Dx12ParameterImpl::Get(const char* InName, void** OutValue) con
 	case Util::NvParameter::DLSSOptimalSettingsCallback:
 		*OutValue = NVSDK_NGX_DLSS_GetOptimalSettingsCallback;
 		break;
+	case Util::NvParameter::CyberFSR_SetFrameParameters:
+		*OutValue = CyberFSR_SetFrameParameters;
+		break;
 	default:
 		*OutValue = nullptr;
 		return NVSDK_NGX_Result_FAIL_InvalidParameter;
@@ -250,6 +289,63 @@ void Dx12ParameterImpl::Reset()
 	//TODO
 }
 
+void Dx12ParameterImpl::SetSharpness(float dlssSharpness)
+{
+	// normalize sharpness value to [0, 1] range
+	// originally in range [-0.99, 1]
+	if (dlssSharpness >= 1.0f) {
+		Sharpness = 1;
+	} else {
+		Sharpness = (dlssSharpness + 0.99f) / 2.0f;
+	}
+}
+
+//Same result as the per key Set calls, minus the string lookups and the debug names on the resources
+void Dx12ParameterImpl::SetFrameParameters(const CyberFsrFrameParameters& frameParameters)
+{
+	Color = frameParameters.Color;
+	Depth = frameParameters.Depth;
+	MotionVectors = frameParameters.MotionVectors;
+	Output = frameParameters.Output;
+	ExposureTexture = frameParameters.ExposureTexture;
+	TransparencyMask = frameParameters.TransparencyMask;
+	InputBiasCurrentColorMask = frameParameters.InputBiasCurrentColorMask;
+
+	JitterOffsetX = frameParameters.JitterOffsetX;
+	JitterOffsetY = frameParameters.JitterOffsetY;
+	MVScaleX = frameParameters.MVScaleX;
+	MVScaleY = frameParameters.MVScaleY;
+	ResetRender = frameParameters.Reset;
+	SetSharpness(frameParameters.Sharpness);
+
+	//engines without subrects leave the keys unset, which keeps Width and Height as well
+	if (frameParameters.RenderSubrectWidth)
+		Width = frameParameters.RenderSubrectWidth;
+	if (frameParameters.RenderSubrectHeight)
+		Height = frameParameters.RenderSubrectHeight;
+
+	//the per key path keeps 1.0 as long as the engine sets nothing, a zeroed block means the same
+	if (frameParameters.Size >= offsetof(CyberFsrFrameParameters, PreExposure) + sizeof(float) && frameParameters.PreExposure != 0.0f)
+		PreExposure = frameParameters.PreExposure;
+
+	if (frameParameters.Size >= offsetof(CyberFsrFrameParameters, ColorOpaqueOnly) + sizeof(ID3D12Resource*))
+		ColorOpaqueOnly = frameParameters.ColorOpaqueOnly;
+}
+
+void Dx12ParameterImpl::RecordSetBatch(unsigned int handle, unsigned long long frame) const
+{
+#if CYBERFSR_TRACE
+	if (setBatch.Count == 0)
+		return;
+
+	setBatch.Name = "NGX parameter batch";
+	setBatch.Handle = handle;
+	setBatch.Frame = frame;
+	Trace::Record(setBatch);
+	setBatch.Count = 0;
+#endif
+}
+
 void Dx12ParameterImpl::EvaluateRenderScale()
 {
 	FfxFsr2QualityMode fsrQualityMode;
@@ -277,3 +373,9 @@ void Dx12ParameterImpl::EvaluateRenderScale()
 
 	ffxFsr2GetRenderResolutionFromQualityMode(&OutWidth, &OutHeight, Width, Height, fsrQualityMode);
 }
+
+void Dx12ParameterImpl::EvaluateRenderScale(float upscaleRatio)
+{
+	OutWidth = static_cast<unsigned int>(Width / upscaleRatio);
+	OutHeight = static_cast<unsigned int>(Height / upscaleRatio);
+}
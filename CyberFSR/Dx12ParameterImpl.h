@@ -1,4 +1,7 @@
 #pragma once
+#include "CyberFsrExt.h"
+#include "Trace.h"
+
 struct Dx12ParameterImpl : NVSDK_NGX_Parameter
 {
 	unsigned int Width{}, Height{}, OutWidth{}, OutHeight{};
@@ -9,7 +12,10 @@ struct Dx12ParameterImpl : NVSDK_NGX_Parameter
 	float MVScaleX = 1.0, MVScaleY = 1.0;
 	float JitterOffsetX{}, JitterOffsetY{};
 
-	bool DepthInverted, AutoExposure, Hdr, EnableSharpening, JitterMotion, LowRes;
+	//DLSS.Exposure.Scale has no FSR2 counterpart, the FSR2 dispatch only takes the pre-exposure
+	float PreExposure = 1.0f;
+
+	bool DepthInverted{}, AutoExposure{}, Hdr{}, EnableSharpening{}, JitterMotion{}, LowRes{};
 
 	//external DirectX12 Resources
 	ID3D12Resource* InputBiasCurrentColorMask = nullptr;
@@ -19,6 +25,8 @@ struct Dx12ParameterImpl : NVSDK_NGX_Parameter
 	ID3D12Resource* Output = nullptr;
 	ID3D12Resource* TransparencyMask = nullptr;
 	ID3D12Resource* ExposureTexture = nullptr;
+	//scene color before transparencies, only used to generate a reactive mask
+	ID3D12Resource* ColorOpaqueOnly = nullptr;
 
 	virtual void Set(const char* InName, unsigned long long InValue) override;
 	virtual void Set(const char* InName, float InValue) override;
@@ -39,4 +47,16 @@ struct Dx12ParameterImpl : NVSDK_NGX_Parameter
 	virtual void Reset() override;
 
 	void EvaluateRenderScale();
+	void EvaluateRenderScale(float upscaleRatio);
+	void SetFrameParameters(const CyberFsrFrameParameters& frameParameters);
+
+	//records the per key Set calls since the last evaluate as one trace zone
+	void RecordSetBatch(unsigned int handle, unsigned long long frame) const;
+
+private:
+	void SetSharpness(float dlssSharpness);
+
+#if CYBERFSR_TRACE
+	mutable Trace::Event setBatch{};
+#endif
 };
@@ -0,0 +1,49 @@
+#include "FeatureDispatch.h"
+
+#include <cstdio>
+
+FeatureDispatch::FeatureDispatch(bool autoExposureRequested, bool generateReactiveMask)
+	: autoExposureRequested(autoExposureRequested), generateReactiveMask(generateReactiveMask)
+{
+}
+
+void FeatureDispatch::Evaluate(const FeatureInputs& inputs, FeatureDispatchCalls& calls)
+{
+	if (!contextCreated)
+	{
+		autoExposure = autoExposureRequested || !inputs.ExposureBound;
+		exposureBound = inputs.ExposureBound;
+		calls.CreateContext(autoExposure);
+		contextCreated = true;
+	}
+	else if (inputs.ExposureBound != exposureBound && !exposureChangeReported)
+	{
+		printf("ExposureTexture got %s after the FSR2 context was created %s auto exposure\n",
+			inputs.ExposureBound ? "bound" : "unbound", autoExposure ? "with" : "without");
+		exposureChangeReported = true;
+	}
+
+	if (!generateReactiveMask || inputs.ReactiveMaskBound || !inputs.OpaqueColorBound)
+		return calls.Dispatch(nullptr);
+
+	if (reactiveMask == nullptr)
+		reactiveMask = calls.CreateReactiveMask();
+
+	calls.GenerateReactiveMask(reactiveMask);
+	calls.Dispatch(reactiveMask);
+}
+
+bool FeatureDispatch::ContextCreated() const
+{
+	return contextCreated;
+}
+
+bool FeatureDispatch::AutoExposure() const
+{
+	return autoExposure;
+}
+
+void* FeatureDispatch::ReactiveMask() const
+{
+	return reactiveMask;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+//The FSR2 calls one evaluation of a feature makes, implemented on FSR2 in CyberFsr.cpp and by a recording stub in the tests
+class FeatureDispatchCalls
+{
+public:
+	virtual ~FeatureDispatchCalls() = default;
+
+	virtual void CreateContext(bool autoExposure) = 0;
+	virtual void* CreateReactiveMask() = 0;
+	virtual void GenerateReactiveMask(void* reactiveMask) = 0;
+	//nullptr for the engine's own reactive mask, if it binds one
+	virtual void Dispatch(void* reactiveMask) = 0;
+};
+
+//What the engine bound for the evaluation
+struct FeatureInputs
+{
+	bool ExposureBound{}, ReactiveMaskBound{}, OpaqueColorBound{};
+};
+
+/*
+DLSS engines either ask for auto exposure or provide ExposureTexture, plenty do neither and leave FSR2 at an exposure of 1.0 without it.
+Whether an exposure is supplied only shows in the evaluate parameters, so the FSR2 context gets created by the first evaluation
+with auto exposure unless the engine binds an exposure texture and didn't ask for it.
+Recreating the context would throw away its history and free resources the GPU may still be using, a later change only gets reported.
+Most titles bind no reactive mask either, if they hand over their opaque only color FSR2 derives one before every dispatch into a mask the feature keeps.
+*/
+class FeatureDispatch
+{
+public:
+	FeatureDispatch() = default;
+	FeatureDispatch(bool autoExposureRequested, bool generateReactiveMask);
+
+	void Evaluate(const FeatureInputs& inputs, FeatureDispatchCalls& calls);
+
+	bool ContextCreated() const;
+	bool AutoExposure() const;
+	//created by the first evaluation that needed it, released with the feature
+	void* ReactiveMask() const;
+
+private:
+	bool autoExposureRequested{}, generateReactiveMask{};
+	bool contextCreated{}, autoExposure{}, exposureBound{}, exposureChangeReported{};
+	void* reactiveMask = nullptr;
+};
@@ -0,0 +1,24 @@
+#include "pch.h"
+#include "Dx12ParameterImpl.h"
+#include "CyberFsrExt.h"
+#include "Trace.h"
+
+/*
+Kept apart from the other exports so tests/ParameterBenchmark can link the real entry point without FSR2's D3D12 backend.
+Later versions only append fields. Size has to cover at least the version 1 fields, which end with the render subrect,
+SetFrameParameters reads an appended field only if Size covers it.
+*/
+NVSDK_NGX_Result NVSDK_CONV CyberFSR_SetFrameParameters(NVSDK_NGX_Parameter* InParameters, const CyberFsrFrameParameters* InFrameParameters)
+{
+	TRACE_ZONE("CyberFSR_SetFrameParameters");
+
+	auto* params = dynamic_cast<Dx12ParameterImpl*>(InParameters);
+
+	constexpr size_t version1Size = offsetof(CyberFsrFrameParameters, RenderSubrectHeight) + sizeof(unsigned int);
+
+	if (params == nullptr || InFrameParameters == nullptr || InFrameParameters->Version < 1 || InFrameParameters->Size < version1Size)
+		return NVSDK_NGX_Result_FAIL_InvalidParameter;
+
+	params->SetFrameParameters(*InFrameParameters);
+	return NVSDK_NGX_Result_Success;
+}
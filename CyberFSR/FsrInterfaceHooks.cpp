@@ -0,0 +1,261 @@
+#include "pch.h"
+#include "Config.h"
+#include "CyberFsr.h"
+#include "SharedResources.h"
+#include "DirectXHooks.h"
+#include "BatchSchedule.h"
+#include "Trace.h"
+#include "FsrInterfaceHooks.h"
+
+/*
+Every FfxFsr2Context talks to the DX12 backend through the FfxFsr2Interface it got created with.
+We keep a copy of the backend callbacks and replace the ones the shim needs to see, the replacements forward to the backend afterwards.
+The FeatureContext that owns a callback invocation is found through the scratch buffer the interface was created with.
+*/
+
+FfxFsr2Interface dx12Interface = {};
+
+//Pipelines only depend on the pass and the context flags, contexts a batched evaluation created with the same flags share them
+struct SharedPipeline
+{
+	FfxPipelineState Pipeline = {};
+	unsigned int RefCount{};
+};
+
+std::map<std::pair<FfxFsr2Pass, uint32_t>, SharedPipeline> sharedPipelines;
+
+std::mutex pipelineMutex;
+
+//pass of every pipeline handed out, lets trace zones name the jobs
+std::unordered_map<void*, FfxFsr2Pass> pipelinePasses;
+
+//FSR2 pass of a compute job, clears, copies and unknown pipelines get negative keys
+int JobKey(const FfxGpuJobDescription* job)
+{
+	if (job->jobType != FFX_GPU_JOB_COMPUTE)
+		return -1 - static_cast<int>(job->jobType);
+
+	std::lock_guard<std::mutex> lock(pipelineMutex);
+	auto it = pipelinePasses.find(job->computeJobDescriptor.pipeline.pipeline);
+	return it != pipelinePasses.end() ? static_cast<int>(it->second) : -1 - FFX_GPU_JOB_COMPUTE;
+}
+
+const char* JobName(const FfxGpuJobDescription* job)
+{
+	if (job->jobType == FFX_GPU_JOB_CLEAR_FLOAT)
+		return "FSR2 clear";
+	if (job->jobType == FFX_GPU_JOB_COPY)
+		return "FSR2 copy";
+
+	switch (JobKey(job))
+	{
+	case FFX_FSR2_PASS_DEPTH_CLIP:
+		return "FSR2 depth clip";
+	case FFX_FSR2_PASS_RECONSTRUCT_PREVIOUS_DEPTH:
+		return "FSR2 reconstruct previous depth";
+	case FFX_FSR2_PASS_LOCK:
+		return "FSR2 lock";
+	case FFX_FSR2_PASS_ACCUMULATE:
+		return "FSR2 accumulate";
+	case FFX_FSR2_PASS_ACCUMULATE_SHARPEN:
+		return "FSR2 accumulate sharpen";
+	case FFX_FSR2_PASS_RCAS:
+		return "FSR2 rcas";
+	case FFX_FSR2_PASS_COMPUTE_LUMINANCE_PYRAMID:
+		return "FSR2 luminance pyramid";
+	case FFX_FSR2_PASS_GENERATE_REACTIVE:
+		return "FSR2 generate reactive";
+	default:
+		return "FSR2 compute";
+	}
+}
+
+FfxErrorCode hCreateResource(FfxFsr2Interface* backendInterface, const FfxCreateResourceDescription* createResourceDescription, FfxResourceInternal* outResource)
+{
+	auto* deviceContext = CyberFsrContext::instance().GetContext(backendInterface);
+	const auto& config = Config::instance();
+
+	if (deviceContext == nullptr || !(config.ShareTransientResources || config.AsyncComputeUpscale))
+		return dx12Interface.fpCreateResource(backendInterface, createResourceDescription, outResource);
+
+	auto& pool = SharedResourcePool::instance();
+	if (config.ShareTransientResources)
+		pool.BeginCreate(deviceContext, createResourceDescription->id);
+	createForComputeQueue = config.AsyncComputeUpscale;
+
+	FfxErrorCode errorCode = dx12Interface.fpCreateResource(backendInterface, createResourceDescription, outResource);
+
+	createForComputeQueue = false;
+	pool.EndCreate();
+
+	return errorCode;
+}
+
+FfxErrorCode hCreatePipeline(FfxFsr2Interface* backendInterface, FfxFsr2Pass passId, const FfxPipelineDescription* pipelineDescription, FfxPipelineState* outPipeline)
+{
+	auto* deviceContext = CyberFsrContext::instance().GetContext(backendInterface);
+
+	std::lock_guard<std::mutex> lock(pipelineMutex);
+
+	//only contexts created by a batched evaluation share, everything else keeps the backend's own pipeline lifetime
+	if (deviceContext == nullptr || !deviceContext->DeferJobs)
+	{
+		FfxErrorCode errorCode = dx12Interface.fpCreatePipeline(backendInterface, passId, pipelineDescription, outPipeline);
+		if (errorCode == FFX_OK)
+			pipelinePasses[outPipeline->pipeline] = passId;
+
+		return errorCode;
+	}
+
+	auto& sharedPipeline = sharedPipelines[{ passId, pipelineDescription->contextFlags }];
+
+	if (sharedPipeline.RefCount == 0)
+	{
+		FfxErrorCode errorCode = dx12Interface.fpCreatePipeline(backendInterface, passId, pipelineDescription, &sharedPipeline.Pipeline);
+		if (errorCode != FFX_OK)
+			return errorCode;
+	}
+
+	sharedPipeline.RefCount++;
+	*outPipeline = sharedPipeline.Pipeline;
+	pipelinePasses[sharedPipeline.Pipeline.pipeline] = passId;
+
+	return FFX_OK;
+}
+
+FfxErrorCode hDestroyPipeline(FfxFsr2Interface* backendInterface, FfxPipelineState* pipeline)
+{
+	std::lock_guard<std::mutex> lock(pipelineMutex);
+
+	auto it = std::find_if(sharedPipelines.begin(), sharedPipelines.end(),
+		[pipeline](const auto& p) { return pipeline->pipeline != nullptr && p.second.Pipeline.pipeline == pipeline->pipeline; });
+
+	if (it == sharedPipelines.end())
+	{
+		pipelinePasses.erase(pipeline->pipeline);
+		return dx12Interface.fpDestroyPipeline(backendInterface, pipeline);
+	}
+
+	FfxErrorCode errorCode = FFX_OK;
+
+	if (--it->second.RefCount == 0)
+	{
+		pipelinePasses.erase(it->second.Pipeline.pipeline);
+		errorCode = dx12Interface.fpDestroyPipeline(backendInterface, &it->second.Pipeline);
+		sharedPipelines.erase(it);
+	}
+
+	return errorCode;
+}
+
+FfxErrorCode hScheduleGpuJob(FfxFsr2Interface* backendInterface, const FfxGpuJobDescription* job)
+{
+	auto* deviceContext = CyberFsrContext::instance().GetContext(backendInterface);
+
+#if CYBERFSR_TRACE
+	Trace::Zone traceZone(JobName(job), deviceContext ? deviceContext->Handle.Id : 0, deviceContext ? deviceContext->FrameIndex : 0);
+#endif
+
+	if (deviceContext && deviceContext->DeferJobs)
+	{
+		deviceContext->BackendInterface = backendInterface;
+		deviceContext->DeferredJobs.push_back(*job);
+		return FFX_OK;
+	}
+
+	return dx12Interface.fpScheduleGpuJob(backendInterface, job);
+}
+
+FfxErrorCode hExecuteGpuJobs(FfxFsr2Interface* backendInterface, FfxCommandList commandList)
+{
+	auto* deviceContext = CyberFsrContext::instance().GetContext(backendInterface);
+
+	if (deviceContext && deviceContext->DeferJobs)
+		return FFX_OK;
+
+#if CYBERFSR_TRACE
+	Trace::Zone traceZone("FSR2 execute jobs", deviceContext ? deviceContext->Handle.Id : 0, deviceContext ? deviceContext->FrameIndex : 0);
+#endif
+
+	return dx12Interface.fpExecuteGpuJobs(backendInterface, commandList);
+}
+
+//the registered engine resources have to stay valid until the deferred jobs ran
+FfxErrorCode hUnregisterResources(FfxFsr2Interface* backendInterface)
+{
+	auto* deviceContext = CyberFsrContext::instance().GetContext(backendInterface);
+
+	if (deviceContext && deviceContext->DeferJobs)
+		return FFX_OK;
+
+	return dx12Interface.fpUnregisterResources(backendInterface);
+}
+
+void HookFsrInterface(FfxFsr2Interface* callbacks)
+{
+	if (dx12Interface.fpCreateResource == nullptr)
+		dx12Interface = *callbacks;
+
+	callbacks->fpCreateResource = hCreateResource;
+	callbacks->fpCreatePipeline = hCreatePipeline;
+	callbacks->fpDestroyPipeline = hDestroyPipeline;
+	callbacks->fpScheduleGpuJob = hScheduleGpuJob;
+	callbacks->fpExecuteGpuJobs = hExecuteGpuJobs;
+	callbacks->fpUnregisterResources = hUnregisterResources;
+}
+
+void ExecuteDeferredJobs(const std::vector<FeatureContext*>& features, ID3D12GraphicsCommandList* InCmdList, bool interleave)
+{
+	TRACE_ZONE("Execute deferred jobs");
+	const FfxCommandList commandList = ffxGetCommandListDX12(InCmdList);
+
+	std::vector<std::pair<size_t, size_t>> order;
+
+	if (interleave)
+	{
+		std::vector<std::vector<int>> jobKeys;
+		jobKeys.reserve(features.size());
+
+		for (auto* deviceContext : features)
+		{
+			auto& keys = jobKeys.emplace_back();
+			for (const auto& job : deviceContext->DeferredJobs)
+				keys.push_back(JobKey(&job));
+		}
+
+		order = InterleaveJobs(jobKeys);
+	}
+	else
+	{
+		for (size_t feature = 0; feature < features.size(); feature++)
+		{
+			for (size_t job = 0; job < features[feature]->DeferredJobs.size(); job++)
+				order.emplace_back(feature, job);
+		}
+	}
+
+	//the backend flushes its barriers and binds per execute, so every job gets executed on its own
+	ExecuteBatch(InCmdList, order, [&](size_t feature, size_t job)
+	{
+		auto* deviceContext = features[feature];
+		const auto& jobDescription = deviceContext->DeferredJobs[job];
+
+		//one feature after another, aliased transient resources only need the barrier at the start of each
+		if (!interleave && job == 0)
+			SharedResourcePool::instance().BeginAccess(deviceContext, InCmdList);
+
+		TRACE_FEATURE_ZONE(JobName(&jobDescription), deviceContext);
+		dx12Interface.fpScheduleGpuJob(deviceContext->BackendInterface, &jobDescription);
+		dx12Interface.fpExecuteGpuJobs(deviceContext->BackendInterface, commandList);
+	});
+
+	for (auto* deviceContext : features)
+	{
+		deviceContext->DeferJobs = false;
+
+		if (deviceContext->BackendInterface)
+			dx12Interface.fpUnregisterResources(deviceContext->BackendInterface);
+
+		deviceContext->DeferredJobs.clear();
+	}
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include "pch.h"
+
+//the unmodified callbacks of the FSR2 DX12 backend
+extern FfxFsr2Interface dx12Interface;
+
+class FeatureContext;
+
+void HookFsrInterface(FfxFsr2Interface* callbacks);
+
+//Executes the jobs the features deferred during a batched evaluation, either grouped by pass across all features or one feature after another
+void ExecuteDeferredJobs(const std::vector<FeatureContext*>& features, ID3D12GraphicsCommandList* InCmdList, bool interleave);
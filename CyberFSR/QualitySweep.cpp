@@ -0,0 +1,173 @@
+#include "QualitySweep.h"
+
+#include <algorithm>
+#include <fstream>
+
+struct Percentiles
+{
+	double Average{}, P95{}, P99{};
+};
+
+//index of the nearest-rank percentile, ceil(percent / 100 * count) - 1, in integers so 95 of 100 doesn't round up a rank
+static size_t NearestRank(size_t count, size_t percent)
+{
+	return (count * percent + 99) / 100 - 1;
+}
+
+static Percentiles ComputePercentiles(std::vector<double> values)
+{
+	Percentiles result;
+	if (values.empty())
+		return result;
+
+	std::sort(values.begin(), values.end());
+
+	for (double value : values)
+		result.Average += value;
+	result.Average /= values.size();
+
+	result.P95 = values[NearestRank(values.size(), 95)];
+	result.P99 = values[NearestRank(values.size(), 99)];
+
+	return result;
+}
+
+QualitySweep::QualitySweep(std::vector<Step> steps, Timing timing)
+	: steps(std::move(steps)), timing(timing)
+{
+	results.resize(this->steps.size());
+}
+
+void QualitySweep::Start()
+{
+	started = true;
+}
+
+bool QualitySweep::Started() const
+{
+	return started;
+}
+
+bool QualitySweep::Active() const
+{
+	return started && currentStep < steps.size();
+}
+
+const QualitySweep::Step& QualitySweep::CurrentStep() const
+{
+	return steps[currentStep];
+}
+
+const std::vector<QualitySweep::StepResult>& QualitySweep::Results() const
+{
+	return results;
+}
+
+void QualitySweep::OnOptimalSettings(unsigned int renderWidth, unsigned int renderHeight)
+{
+	if (!Active())
+		return;
+
+	auto& result = results[currentStep];
+	result.ExpectedWidth = renderWidth;
+	result.ExpectedHeight = renderHeight;
+}
+
+bool QualitySweep::Follows(unsigned int feature)
+{
+	if (!hasFeature)
+	{
+		hasFeature = true;
+		this->feature = feature;
+	}
+
+	return this->feature == feature;
+}
+
+void QualitySweep::OnFeatureReleased(unsigned int feature)
+{
+	if (hasFeature && this->feature == feature)
+		hasFeature = false;
+}
+
+bool QualitySweep::OnFrame(double frameTime, double shimTime, unsigned int renderWidth, unsigned int renderHeight)
+{
+	if (!Active())
+		return false;
+
+	if (startFrame < timing.StartDelayFrames)
+	{
+		startFrame++;
+		return false;
+	}
+
+	auto& result = results[currentStep];
+	const bool expectedSize = result.ExpectedWidth != 0 && renderWidth == result.ExpectedWidth && renderHeight == result.ExpectedHeight;
+
+	//most engines only query the optimal settings again when a setting changes, don't measure the previous step's size under this one's name
+	if (!settled)
+	{
+		if (!expectedSize && stepFrame++ < timing.SettleFrames)
+			return false;
+
+		settled = true;
+		stepFrame = 0;
+	}
+
+	if (stepFrame++ >= timing.WarmupFrames)
+	{
+		result.RenderWidth = renderWidth;
+		result.RenderHeight = renderHeight;
+		result.SizeMismatch |= !expectedSize;
+		result.FrameTimes.push_back(frameTime);
+		result.ShimTimes.push_back(shimTime);
+	}
+
+	if (stepFrame < timing.WarmupFrames + timing.FramesPerStep)
+		return false;
+
+	settled = false;
+	stepFrame = 0;
+	currentStep++;
+
+	return !Active();
+}
+
+bool QualitySweep::WriteReport(const std::filesystem::path& path) const
+{
+	auto csvPath = path, jsonPath = path;
+	std::ofstream csv(csvPath += ".csv");
+	std::ofstream json(jsonPath += ".json");
+	if (!csv || !json)
+		return false;
+
+	csv << "step,perf_quality,upscale_ratio,expected_width,expected_height,render_width,render_height,size_mismatch,frames,frame_avg_ms,frame_p95_ms,frame_p99_ms,shim_avg_ms,shim_p95_ms,shim_p99_ms\n";
+	json << "{\"steps\":[";
+
+	for (size_t i = 0; i < steps.size(); i++)
+	{
+		const auto& step = steps[i];
+		const auto& result = results[i];
+		const auto frame = ComputePercentiles(result.FrameTimes);
+		const auto shim = ComputePercentiles(result.ShimTimes);
+
+		csv << i << "," << step.Name << "," << step.UpscaleRatio << ","
+			<< result.ExpectedWidth << "," << result.ExpectedHeight << ","
+			<< result.RenderWidth << "," << result.RenderHeight << "," << result.SizeMismatch << "," << result.FrameTimes.size() << ","
+			<< frame.Average << "," << frame.P95 << "," << frame.P99 << ","
+			<< shim.Average << "," << shim.P95 << "," << shim.P99 << "\n";
+
+		json << (i ? "," : "") << "\n{\"step\":" << i << ",\"perfQuality\":\"" << step.Name << "\""
+			<< ",\"upscaleRatio\":" << step.UpscaleRatio
+			<< ",\"expectedWidth\":" << result.ExpectedWidth << ",\"expectedHeight\":" << result.ExpectedHeight
+			<< ",\"renderWidth\":" << result.RenderWidth << ",\"renderHeight\":" << result.RenderHeight
+			<< ",\"sizeMismatch\":" << (result.SizeMismatch ? "true" : "false")
+			<< ",\"frames\":" << result.FrameTimes.size()
+			<< ",\"frameTime\":{\"avg\":" << frame.Average << ",\"p95\":" << frame.P95 << ",\"p99\":" << frame.P99 << "}"
+			<< ",\"shimTime\":{\"avg\":" << shim.Average << ",\"p95\":" << shim.P95 << ",\"p99\":" << shim.P99 << "}}";
+	}
+
+	json << "\n]}\n";
+
+	return csv.good() && json.good();
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <filesystem>
+#include <vector>
+
+/*
+Benchmark mode for picking a title's default quality mode, enabled through [Benchmark] in nvngx.ini.
+Steps through every PerfQualityValue that Dx12ParameterImpl::EvaluateRenderScale knows plus the configured custom upscale ratios,
+the step decides what the optimal settings callback answers, so the engine has to query it again to pick up a switch.
+Nothing runs before Start, afterwards the sweep waits StartDelayFrames so the scene can be set up.
+A step holds until the engine renders at the size the callback answered for it, after SettleFrames it gets measured anyway and flagged in the report.
+The first frames after every switch are discarded, afterwards frame time and time spent in the shim are collected.
+Once all steps ran a CSV and a JSON report get written and the engine's own quality setting applies again.
+*/
+class QualitySweep
+{
+public:
+	struct Step
+	{
+		const char* Name;
+		int PerfQualityValue;	//NVSDK_NGX_PerfQuality_Value
+		float UpscaleRatio;	//0 for the quality mode's own ratio
+	};
+
+	struct Timing
+	{
+		unsigned int StartDelayFrames{}, SettleFrames{}, WarmupFrames{}, FramesPerStep{};
+	};
+
+	struct StepResult
+	{
+		//what the optimal settings callback answered for the step, 0 if the engine never asked
+		unsigned int ExpectedWidth{}, ExpectedHeight{};
+		unsigned int RenderWidth{}, RenderHeight{};
+		bool SizeMismatch{};
+		std::vector<double> FrameTimes, ShimTimes;
+	};
+
+	QualitySweep(std::vector<Step> steps, Timing timing);
+
+	void Start();
+	bool Started() const;
+	bool Active() const;
+	const Step& CurrentStep() const;
+	const std::vector<StepResult>& Results() const;
+
+	//the render size the optimal settings callback answered for the current step
+	void OnOptimalSettings(unsigned int renderWidth, unsigned int renderHeight);
+
+	//titles with several views evaluate several features per frame, the first feature asked about drives the sweep until it gets released
+	bool Follows(unsigned int feature);
+	void OnFeatureReleased(unsigned int feature);
+
+	//call once per frame, returns true when the last step just completed
+	bool OnFrame(double frameTime, double shimTime, unsigned int renderWidth, unsigned int renderHeight);
+
+	//writes path.csv and path.json
+	bool WriteReport(const std::filesystem::path& path) const;
+
+private:
+	std::vector<Step> steps;
+	std::vector<StepResult> results;
+	Timing timing;
+	bool started{}, settled{}, hasFeature{};
+	unsigned int feature{};
+	size_t currentStep{};
+	unsigned int startFrame{}, stepFrame{};
+};
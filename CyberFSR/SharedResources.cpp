@@ -0,0 +1,159 @@
+#include "pch.h"
+#include "CyberFsr.h"
+#include "SharedResources.h"
+
+#include <ffx-fsr2-api/ffx_fsr2_resources.h>
+
+thread_local FeatureContext* SharedResourcePool::pendingFeature = nullptr;
+thread_local uint32_t SharedResourcePool::pendingResourceId = 0;
+
+bool SharedResourcePool::IsTransient(uint32_t resourceId)
+{
+	//written from scratch by every dispatch before they are read, everything else carries history or init data
+	switch (resourceId)
+	{
+	case FFX_FSR2_RESOURCE_IDENTIFIER_RECONSTRUCTED_PREVIOUS_NEAREST_DEPTH:
+	case FFX_FSR2_RESOURCE_IDENTIFIER_DILATED_DEPTH:
+	case FFX_FSR2_RESOURCE_IDENTIFIER_DEPTH_CLIP:
+	case FFX_FSR2_RESOURCE_IDENTIFIER_PREPARED_INPUT_COLOR:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void SharedResourcePool::BeginCreate(FeatureContext* feature, uint32_t resourceId)
+{
+	pendingFeature = feature;
+	pendingResourceId = resourceId;
+}
+
+void SharedResourcePool::EndCreate()
+{
+	pendingFeature = nullptr;
+}
+
+bool SharedResourcePool::HasPendingCreate() const
+{
+	return pendingFeature != nullptr;
+}
+
+ID3D12Heap* SharedResourcePool::PlaceResource(ID3D12Device* device, const D3D12_HEAP_PROPERTIES* heapProperties, const D3D12_RESOURCE_DESC* desc)
+{
+	auto* feature = pendingFeature;
+	//only the first allocation belongs to the FSR2 resource, the backend might create upload buffers afterwards
+	pendingFeature = nullptr;
+
+	const auto allocationInfo = device->GetResourceAllocationInfo(0, 1, desc);
+
+	std::lock_guard<std::mutex> lock(poolMutex);
+
+	auto& memory = features[feature->Handle.Id];
+	memory.TotalBytes += allocationInfo.SizeInBytes;
+	unsharedBytes += allocationInfo.SizeInBytes;
+
+	const bool canAlias = IsTransient(pendingResourceId)
+		&& heapProperties->Type == D3D12_HEAP_TYPE_DEFAULT
+		&& desc->Dimension != D3D12_RESOURCE_DIMENSION_BUFFER
+		&& !(desc->Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL));
+
+	ID3D12Heap* result = nullptr;
+
+	if (canAlias)
+	{
+		auto& sharedHeap = heaps[HeapKey(pendingResourceId, desc->Width, desc->Height, desc->Format, desc->MipLevels, desc->Flags)];
+
+		if (sharedHeap.Heap == nullptr)
+		{
+			D3D12_HEAP_DESC heapDesc = {};
+			heapDesc.SizeInBytes = allocationInfo.SizeInBytes;
+			heapDesc.Properties = *heapProperties;
+			heapDesc.Alignment = allocationInfo.Alignment;
+			heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+
+			if (SUCCEEDED(device->CreateHeap(&heapDesc, IID_PPV_ARGS(&sharedHeap.Heap))))
+			{
+				sharedHeap.Size = allocationInfo.SizeInBytes;
+				residentBytes += sharedHeap.Size;
+			}
+		}
+
+		if (sharedHeap.Heap)
+		{
+			sharedHeap.RefCount++;
+			memory.Heaps.push_back(&sharedHeap);
+			result = sharedHeap.Heap;
+		}
+	}
+
+	if (result == nullptr)
+	{
+		memory.CommittedBytes += allocationInfo.SizeInBytes;
+		residentBytes += allocationInfo.SizeInBytes;
+	}
+
+	peakUnsharedBytes = (std::max)(peakUnsharedBytes, unsharedBytes);
+	peakResidentBytes = (std::max)(peakResidentBytes, residentBytes);
+
+	return result;
+}
+
+void SharedResourcePool::BeginAccess(FeatureContext* feature, ID3D12GraphicsCommandList* cmdList)
+{
+	bool shared = false;
+
+	{
+		std::lock_guard<std::mutex> lock(poolMutex);
+
+		auto it = features.find(feature->Handle.Id);
+		if (it == features.end())
+			return;
+
+		shared = std::any_of(it->second.Heaps.begin(), it->second.Heaps.end(), [](const SharedHeap* sharedHeap) { return sharedHeap->RefCount > 1; });
+	}
+
+	if (shared)
+	{
+		//null before and after resources cover every placed resource that might alias
+		D3D12_RESOURCE_BARRIER barrier = {};
+		barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+		cmdList->ResourceBarrier(1, &barrier);
+	}
+}
+
+void SharedResourcePool::ReleaseFeature(FeatureContext* feature)
+{
+	{
+		std::lock_guard<std::mutex> lock(poolMutex);
+
+		auto it = features.find(feature->Handle.Id);
+		if (it == features.end())
+			return;
+
+		unsharedBytes -= it->second.TotalBytes;
+		residentBytes -= it->second.CommittedBytes;
+
+		for (auto* sharedHeap : it->second.Heaps)
+		{
+			if (--sharedHeap->RefCount == 0)
+			{
+				residentBytes -= sharedHeap->Size;
+				sharedHeap->Heap->Release();
+				sharedHeap->Heap = nullptr;
+			}
+		}
+
+		features.erase(it);
+	}
+
+	ReportMemory("released");
+}
+
+void SharedResourcePool::ReportMemory(const char* event)
+{
+	std::lock_guard<std::mutex> lock(poolMutex);
+
+	constexpr double MiB = 1024.0 * 1024.0;
+	printf("FSR2 resources %s: %.1f MiB resident (peak %.1f MiB), %.1f MiB without aliasing (peak %.1f MiB)\n", event,
+		residentBytes / MiB, peakResidentBytes / MiB, unsharedBytes / MiB, peakUnsharedBytes / MiB);
+}
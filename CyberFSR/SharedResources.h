@@ -0,0 +1,64 @@
+#pragma once
+#include "pch.h"
+
+class FeatureContext;
+
+/*
+Every FeatureContext owns a full FfxFsr2Context, so titles that keep several features alive (menu viewport, photo mode, a stale feature after a resolution switch) pay for all FSR2 surfaces once per feature.
+Resources that FSR2 fully rewrites every dispatch don't need to survive between frames, so features with identical resource descriptions can place them in one shared heap.
+Features can be evaluated into different command lists that execute in any order, even within one ExecuteCommandLists call, so recording order says nothing about which feature touched a heap last.
+A feature placed in a heap that another feature uses as well therefore issues an aliasing barrier before every dispatch.
+*/
+class SharedResourcePool
+{
+public:
+	//called around FfxFsr2Interface::fpCreateResource, the device hook picks up the pending resource
+	void BeginCreate(FeatureContext* feature, uint32_t resourceId);
+	void EndCreate();
+	bool HasPendingCreate() const;
+
+	//returns the shared heap the pending resource has to be placed in, nullptr if it stays a committed resource
+	ID3D12Heap* PlaceResource(ID3D12Device* device, const D3D12_HEAP_PROPERTIES* heapProperties, const D3D12_RESOURCE_DESC* desc);
+
+	//aliasing barrier before the feature's jobs, if any of its heaps has another user
+	void BeginAccess(FeatureContext* feature, ID3D12GraphicsCommandList* cmdList);
+	void ReleaseFeature(FeatureContext* feature);
+	void ReportMemory(const char* event);
+
+	static SharedResourcePool& instance()
+	{
+		static SharedResourcePool INSTANCE;
+		return INSTANCE;
+	}
+
+private:
+	SharedResourcePool() {}
+
+	struct SharedHeap
+	{
+		ID3D12Heap* Heap = nullptr;
+		UINT64 Size{};
+		unsigned int RefCount{};
+	};
+
+	struct FeatureMemory
+	{
+		std::vector<SharedHeap*> Heaps;
+		UINT64 TotalBytes{}, CommittedBytes{};
+	};
+
+	using HeapKey = std::tuple<uint32_t, UINT64, UINT, DXGI_FORMAT, UINT16, D3D12_RESOURCE_FLAGS>;
+
+	std::mutex poolMutex;
+	std::map<HeapKey, SharedHeap> heaps;
+	std::unordered_map<unsigned int, FeatureMemory> features;
+
+	//what FSR2 would have allocated without aliasing vs what is actually allocated
+	UINT64 unsharedBytes{}, residentBytes{};
+	UINT64 peakUnsharedBytes{}, peakResidentBytes{};
+
+	static thread_local FeatureContext* pendingFeature;
+	static thread_local uint32_t pendingResourceId;
+
+	static bool IsTransient(uint32_t resourceId);
+};
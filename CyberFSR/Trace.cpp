@@ -0,0 +1,98 @@
+#include "pch.h"
+#include "Util.h"
+#include "Trace.h"
+#include "TraceRing.h"
+
+std::mutex Trace::buffersMutex;
+std::vector<std::unique_ptr<Trace::Buffer>> Trace::buffers;
+
+Trace::Zone::Zone(const char* name, unsigned int handle, unsigned long long frame)
+{
+	event.Name = name;
+	event.Handle = handle;
+	event.Frame = frame;
+	event.Count = 0;
+	event.Start = Util::MillisecondsNow();
+}
+
+Trace::Zone::~Zone()
+{
+	event.Duration = Util::MillisecondsNow() - event.Start;
+	Record(event);
+}
+
+Trace::Buffer* Trace::ThreadBuffer()
+{
+	thread_local Buffer* buffer = nullptr;
+
+	if (buffer == nullptr)
+	{
+		//buffers outlive their threads so a dump still sees the events of finished threads
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		buffers.push_back(std::make_unique<Buffer>());
+		buffer = buffers.back().get();
+		buffer->ThreadId = GetCurrentThreadId();
+	}
+
+	return buffer;
+}
+
+void Trace::Record(const Event& event)
+{
+	auto* buffer = ThreadBuffer();
+	const auto head = buffer->Head.load(std::memory_order_relaxed);
+	buffer->Events[head % Capacity] = event;
+	buffer->Head.store(head + 1, std::memory_order_release);
+}
+
+bool Trace::WriteChromeTrace(const wchar_t* path)
+{
+	std::ofstream file(path);
+	if (!file)
+		return false;
+
+	const DWORD processId = GetCurrentProcessId();
+	bool first = true;
+
+	file << "{\"traceEvents\":[";
+	file.precision(3);
+	file << std::fixed;
+
+	std::lock_guard<std::mutex> lock(buffersMutex);
+
+	for (const auto& buffer : buffers)
+	{
+		const auto head = buffer->Head.load(std::memory_order_acquire);
+		const auto begin = head > Capacity ? head - Capacity : 0;
+
+		std::vector<Event> events(buffer->Events + (begin % Capacity), buffer->Events + Capacity);
+		events.insert(events.end(), buffer->Events, buffer->Events + (begin % Capacity));
+		events.resize(head - begin);
+
+		//the owning thread kept recording while we copied, drop everything it may have overwritten
+		const auto valid = ValidTraceEvents(head, buffer->Head.load(std::memory_order_acquire), Capacity);
+
+		for (size_t i = valid.Begin - begin; i < events.size(); i++)
+		{
+			const auto& event = events[i];
+
+			file << (first ? "" : ",") << "\n{\"name\":\"" << event.Name << "\",\"cat\":\"CyberFSR\",\"ph\":\"X\""
+				<< ",\"ts\":" << event.Start * 1000.0 << ",\"dur\":" << event.Duration * 1000.0
+				<< ",\"pid\":" << processId << ",\"tid\":" << buffer->ThreadId;
+
+			if (event.Handle)
+				file << ",\"args\":{\"frame\":" << event.Frame << ",\"handle\":" << event.Handle;
+			if (event.Count)
+				file << (event.Handle ? "," : ",\"args\":{") << "\"count\":" << event.Count;
+			if (event.Handle || event.Count)
+				file << "}";
+
+			file << "}";
+			first = false;
+		}
+	}
+
+	file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+	return file.good();
+}
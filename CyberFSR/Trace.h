@@ -0,0 +1,67 @@
+#pragma once
+#include "pch.h"
+
+//Debug builds record trace zones, define CYBERFSR_TRACE=1 to record them in release builds as well
+#ifndef CYBERFSR_TRACE
+#ifdef _DEBUG
+#define CYBERFSR_TRACE 1
+#else
+#define CYBERFSR_TRACE 0
+#endif
+#endif
+
+/*
+Scoped zones are recorded into a ring buffer per thread, only the owning thread writes to it so recording needs no locks.
+WriteChromeTrace dumps whatever is still in the rings as Chrome trace_event JSON, which loads in Perfetto and chrome://tracing.
+Timestamps come from QueryPerformanceCounter like most engine profilers, so captures line up with the engine's own trace.
+*/
+class Trace
+{
+public:
+	struct Event
+	{
+		const char* Name;
+		double Start, Duration;
+		unsigned long long Frame;
+		unsigned int Handle;
+		unsigned int Count;	//calls covered by the zone, 0 for a single scope
+	};
+
+	class Zone
+	{
+	public:
+		Zone(const char* name, unsigned int handle = 0, unsigned long long frame = 0);
+		~Zone();
+
+	private:
+		Event event;
+	};
+
+	static void Record(const Event& event);
+	static bool WriteChromeTrace(const wchar_t* path);
+
+private:
+	static constexpr size_t Capacity = 8192;
+
+	struct Buffer
+	{
+		DWORD ThreadId{};
+		std::atomic<unsigned long long> Head{};
+		Event Events[Capacity];
+	};
+
+	static Buffer* ThreadBuffer();
+
+	static std::mutex buffersMutex;
+	static std::vector<std::unique_ptr<Buffer>> buffers;
+};
+
+#if CYBERFSR_TRACE
+#define TRACE_ZONE_CONCAT_INNER(a, b) a##b
+#define TRACE_ZONE_CONCAT(a, b) TRACE_ZONE_CONCAT_INNER(a, b)
+#define TRACE_ZONE(name) Trace::Zone TRACE_ZONE_CONCAT(traceZone, __LINE__)(name)
+#define TRACE_FEATURE_ZONE(name, feature) Trace::Zone TRACE_ZONE_CONCAT(traceZone, __LINE__)(name, (feature)->Handle.Id, (feature)->FrameIndex)
+#else
+#define TRACE_ZONE(name)
+#define TRACE_FEATURE_ZONE(name, feature)
+#endif
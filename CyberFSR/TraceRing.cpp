@@ -0,0 +1,17 @@
+#include "TraceRing.h"
+
+TraceRingRange ValidTraceEvents(unsigned long long head, unsigned long long headAfterCopy, size_t capacity)
+{
+	TraceRingRange range;
+	range.Begin = head > capacity ? head - capacity : 0;
+	range.End = head;
+
+	//the first event the owner can't have touched yet
+	if (headAfterCopy + 1 > capacity && headAfterCopy + 1 - capacity > range.Begin)
+		range.Begin = headAfterCopy + 1 - capacity;
+
+	if (range.Begin > range.End)
+		range.Begin = range.End;
+
+	return range;
+}
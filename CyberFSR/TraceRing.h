@@ -0,0 +1,13 @@
+#pragma once
+#include <cstddef>
+
+/*
+Events of a per thread trace ring that can be trusted after a reader copied the slots of [head - capacity, head).
+Its owner writes slot headAfterCopy % capacity before it bumps Head, so every copied event at or below headAfterCopy - capacity may be torn.
+*/
+struct TraceRingRange
+{
+	unsigned long long Begin{}, End{};
+};
+
+TraceRingRange ValidTraceEvents(unsigned long long head, unsigned long long headAfterCopy, size_t capacity);
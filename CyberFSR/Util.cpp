@@ -49,6 +49,7 @@ Util::NvParameter Util::NvParameterToEnum(const char* name)
 
 	{"DLSSOptimalSettingsCallback", NvParameter::DLSSOptimalSettingsCallback},
 	{"DLSSGetStatsCallback", NvParameter::DLSSGetStatsCallback},
+	{"CyberFSR.SetFrameParameters", NvParameter::CyberFSR_SetFrameParameters},
 
 	{"CreationNodeMask", NvParameter::CreationNodeMask},
 	{"VisibilityNodeMask", NvParameter::VisibilityNodeMask},
@@ -62,6 +63,7 @@ Util::NvParameter Util::NvParameterToEnum(const char* name)
 	{"TransparencyMask", NvParameter::TransparencyMask},
 	{"ExposureTexture", NvParameter::ExposureTexture},
 	{"DLSS.Input.Bias.Current.Color.Mask", NvParameter::DLSS_Input_Bias_Current_Color_Mask},
+	{"CyberFSR.Color.Opaque.Only", NvParameter::CyberFSR_Color_Opaque_Only},
 
 	{"DLSS.Pre.Exposure", NvParameter::Pre_Exposure},
 	{"DLSS.Exposure.Scale", NvParameter::Exposure_Scale},
@@ -34,6 +34,7 @@ public:
 		//Callbacks
 		DLSSGetStatsCallback,
 		DLSSOptimalSettingsCallback,
+		CyberFSR_SetFrameParameters,
 
 		//Render stuff
 		CreationNodeMask,
@@ -49,6 +50,7 @@ public:
 		TransparencyMask,
 		ExposureTexture,
 		DLSS_Input_Bias_Current_Color_Mask,
+		CyberFSR_Color_Opaque_Only,
 		Pre_Exposure,
 		Exposure_Scale,
 
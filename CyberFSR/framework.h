@@ -7,9 +7,15 @@
 #include <wrl/wrappers/corewrappers.h>
 #include <memory>
 #include <unordered_map>
+#include <map>
+#include <tuple>
+#include <string>
 #include <vector>
 #include <mutex>
+#include <atomic>
+#include <fstream>
 #include <limits>
+#include <algorithm>
 
 #include <ffx-fsr2-api/ffx_fsr2.h>
 #include <ffx-fsr2-api/dx12/ffx_fsr2_dx12.h>
@@ -0,0 +1,313 @@
+#include "Check.h"
+#include "AsyncComputeScheduler.h"
+
+#include <functional>
+#include <map>
+#include <string>
+
+/*
+Records every queue and fence operation and plays the GPU: a fence reaches a value once the compute queue signaled it.
+Waiting on a value nobody signals would hang the real queue, so the fake fails the test instead.
+*/
+class FakeQueues : public AsyncComputeQueues
+{
+public:
+	std::vector<std::string> log;
+	std::map<unsigned int, uint64_t> signaled, handedOut;
+	unsigned int createdSlots{};
+	bool failCreate{};
+	std::function<void()> onReset;
+
+	bool CreateSlot(unsigned int slot) override
+	{
+		if (failCreate)
+			return false;
+
+		CHECK(slot == createdSlots);
+		createdSlots++;
+		return true;
+	}
+
+	void ResetSlot(unsigned int slot, uint64_t value) override
+	{
+		CHECK(value <= signaled[slot]);
+		if (onReset)
+			onReset();
+	}
+
+	void AbandonSlot(unsigned int slot, uint64_t value) override
+	{
+		CHECK(value > signaled[slot]);
+		signaled[slot] = value;
+		log.push_back("abandon " + std::to_string(slot) + " " + std::to_string(value));
+	}
+
+	void ExecuteEngineLists(const void* const* commandLists, unsigned int count) override
+	{
+		std::string entry = "engine";
+		for (unsigned int i = 0; i < count; i++)
+			entry += " " + *static_cast<const std::string*>(commandLists[i]);
+		log.push_back(entry);
+	}
+
+	void SignalInputs(uint64_t value) override
+	{
+		log.push_back("signal inputs " + std::to_string(value));
+	}
+
+	void WaitInputs(uint64_t value) override
+	{
+		log.push_back("wait inputs " + std::to_string(value));
+	}
+
+	void ExecuteUpscale(unsigned int slot, uint64_t value) override
+	{
+		//fence values of a slot only ever grow
+		CHECK(value > signaled[slot]);
+		signaled[slot] = value;
+		log.push_back("upscale " + std::to_string(slot) + " " + std::to_string(value));
+	}
+
+	void WaitUpscale(unsigned int slot, uint64_t value) override
+	{
+		log.push_back("wait upscale " + std::to_string(slot) + " " + std::to_string(value));
+	}
+};
+
+static const std::string Shadows = "shadows", GBuffer = "gbuffer", Post = "post", Ui = "ui";
+
+static void Submit(AsyncComputeScheduler& scheduler, FakeQueues& queues, std::vector<const std::string*> lists)
+{
+	queues.log.clear();
+	scheduler.Submit(reinterpret_cast<const void* const*>(lists.data()), static_cast<unsigned int>(lists.size()), queues);
+}
+
+static void SplitsAroundTheInputList()
+{
+	AsyncComputeScheduler scheduler;
+	FakeQueues queues;
+	unsigned int slot;
+
+	CHECK(scheduler.Begin(&GBuffer, queues, &slot));
+	Submit(scheduler, queues, { &Shadows, &GBuffer, &Post });
+
+	const std::vector<std::string> expected = {
+		"engine shadows gbuffer",
+		"signal inputs 1",
+		"wait inputs 1",
+		"upscale 0 1",
+		"wait upscale 0 1",
+		"engine post",
+	};
+	CHECK(queues.log == expected);
+
+	//nothing pending, the submission passes through unchanged
+	Submit(scheduler, queues, { &Shadows, &Post });
+	CHECK(queues.log == std::vector<std::string>{ "engine shadows post" });
+}
+
+static void EngineTakesTheWait()
+{
+	AsyncComputeScheduler scheduler;
+	FakeQueues queues;
+	unsigned int slot, fenceSlot;
+	uint64_t value;
+
+	CHECK(!scheduler.TakeFence(&GBuffer, &fenceSlot, &value));
+	CHECK(scheduler.Begin(&GBuffer, queues, &slot));
+	CHECK(scheduler.TakeFence(&GBuffer, &fenceSlot, &value));
+	CHECK(fenceSlot == slot);
+
+	Submit(scheduler, queues, { &GBuffer, &Post });
+
+	const std::vector<std::string> expected = {
+		"engine gbuffer",
+		"signal inputs 1",
+		"wait inputs 1",
+		"upscale 0 1",
+		"engine post",
+	};
+	CHECK(queues.log == expected);
+	CHECK(queues.signaled[fenceSlot] == value);
+}
+
+static void FeaturesInOneListShareASlot()
+{
+	AsyncComputeScheduler scheduler;
+	FakeQueues queues;
+	unsigned int first, second;
+
+	CHECK(scheduler.Begin(&GBuffer, queues, &first));
+	CHECK(scheduler.Begin(&GBuffer, queues, &second));
+	CHECK(first == second);
+	CHECK(scheduler.SlotCount() == 1);
+}
+
+static void TwoUpscalesInOneSubmission()
+{
+	AsyncComputeScheduler scheduler;
+	FakeQueues queues;
+	unsigned int slot;
+
+	CHECK(scheduler.Begin(&GBuffer, queues, &slot));
+	CHECK(scheduler.Begin(&Post, queues, &slot));
+	Submit(scheduler, queues, { &GBuffer, &Post, &Ui });
+
+	const std::vector<std::string> expected = {
+		"engine gbuffer",
+		"signal inputs 1",
+		"wait inputs 1",
+		"upscale 0 1",
+		"wait upscale 0 1",
+		"engine post",
+		"signal inputs 2",
+		"wait inputs 2",
+		"upscale 1 1",
+		"wait upscale 1 1",
+		"engine ui",
+	};
+	CHECK(queues.log == expected);
+}
+
+//more lists evaluated than frames in flight before any submission, every recorded upscale has to reach the GPU
+static void PendingListsAreNeverDropped()
+{
+	AsyncComputeScheduler scheduler;
+	FakeQueues queues;
+	std::vector<std::string> names;
+	for (unsigned int i = 0; i < AsyncComputeScheduler::FrameCount + 2; i++)
+		names.push_back("view" + std::to_string(i));
+
+	std::map<const std::string*, std::pair<unsigned int, uint64_t>> fences;
+	for (const auto& name : names)
+	{
+		unsigned int slot, fenceSlot;
+		uint64_t value;
+		CHECK(scheduler.Begin(&name, queues, &slot));
+		CHECK(scheduler.TakeFence(&name, &fenceSlot, &value));
+		fences[&name] = { fenceSlot, value };
+	}
+
+	CHECK(scheduler.SlotCount() == names.size());
+
+	for (const auto& name : names)
+	{
+		Submit(scheduler, queues, { &name });
+		const auto [slot, value] = fences[&name];
+		CHECK(queues.log.at(3) == "upscale " + std::to_string(slot) + " " + std::to_string(value));
+	}
+}
+
+static void SlotsGetReusedAfterSubmission()
+{
+	AsyncComputeScheduler scheduler;
+	FakeQueues queues;
+
+	for (unsigned int frame = 0; frame < 10; frame++)
+	{
+		unsigned int slot;
+		CHECK(scheduler.Begin(&GBuffer, queues, &slot));
+		CHECK(slot == frame % AsyncComputeScheduler::FrameCount);
+		Submit(scheduler, queues, { &GBuffer });
+	}
+
+	CHECK(scheduler.SlotCount() == AsyncComputeScheduler::FrameCount);
+	CHECK(queues.signaled[0] == 4);
+}
+
+static void FailsOnceEverySlotIsPending()
+{
+	AsyncComputeScheduler scheduler;
+	FakeQueues queues;
+	std::vector<std::string> names(AsyncComputeScheduler::MaxSlots + 1);
+	unsigned int slot;
+
+	for (unsigned int i = 0; i < AsyncComputeScheduler::MaxSlots; i++)
+		CHECK(scheduler.Begin(&names[i], queues, &slot));
+	CHECK(!scheduler.Begin(&names.back(), queues, &slot));
+
+	//a submission frees a slot again
+	Submit(scheduler, queues, { &names[0] });
+	CHECK(scheduler.Begin(&names.back(), queues, &slot));
+	CHECK(slot == 0);
+
+	AsyncComputeScheduler failing;
+	queues.failCreate = true;
+	CHECK(!failing.Begin(&GBuffer, queues, &slot));
+}
+
+//an engine list that got reset instead of submitted must not hold its slot forever
+static void DroppedListsGetReclaimed()
+{
+	AsyncComputeScheduler scheduler;
+	FakeQueues queues;
+	std::vector<std::string> dropped(AsyncComputeScheduler::MaxSlots - 1);
+	unsigned int slot;
+
+	for (auto& name : dropped)
+		CHECK(scheduler.Begin(&name, queues, &slot));
+
+	//one list keeps cycling through the last slot
+	for (unsigned int frame = 0; frame < AsyncComputeScheduler::MaxSlots; frame++)
+	{
+		CHECK(scheduler.Begin(&GBuffer, queues, &slot));
+		Submit(scheduler, queues, { &GBuffer });
+	}
+	CHECK(scheduler.SlotCount() == AsyncComputeScheduler::MaxSlots);
+
+	//the last slot is idle, every further list takes over a dropped one
+	queues.log.clear();
+	std::vector<std::string> views(AsyncComputeScheduler::MaxSlots);
+	for (auto& name : views)
+		CHECK(scheduler.Begin(&name, queues, &slot));
+	CHECK(queues.log.size() == dropped.size());
+	CHECK(queues.log.front() == "abandon 0 1");
+
+	//a dropped list that comes back starts over instead of appending to its old upscale
+	AsyncComputeScheduler reused;
+	queues = FakeQueues();
+	CHECK(reused.Begin(&Post, queues, &slot));
+	for (unsigned int frame = 0; frame < AsyncComputeScheduler::MaxSlots; frame++)
+	{
+		CHECK(reused.Begin(&GBuffer, queues, &slot));
+		Submit(reused, queues, { &GBuffer });
+	}
+	queues.log.clear();
+	CHECK(reused.Begin(&Post, queues, &slot));
+	CHECK(queues.log == std::vector<std::string>{ "abandon 0 1" });
+	Submit(reused, queues, { &Post });
+	CHECK(queues.log.at(3) == "upscale " + std::to_string(slot) + " " + std::to_string(queues.signaled[slot]));
+}
+
+//the wait for a slot's previous upscale must not block submissions from other threads
+static void ResetRunsOutsideTheLock()
+{
+	AsyncComputeScheduler scheduler;
+	FakeQueues queues;
+	unsigned int slot;
+	bool submitted = false;
+
+	CHECK(scheduler.Begin(&GBuffer, queues, &slot));
+	queues.onReset = [&]()
+	{
+		Submit(scheduler, queues, { &GBuffer });
+		submitted = true;
+	};
+	CHECK(scheduler.Begin(&Post, queues, &slot));
+	CHECK(submitted);
+	CHECK(queues.log.at(3) == "upscale 0 1");
+}
+
+int main()
+{
+	SplitsAroundTheInputList();
+	EngineTakesTheWait();
+	FeaturesInOneListShareASlot();
+	TwoUpscalesInOneSubmission();
+	PendingListsAreNeverDropped();
+	SlotsGetReusedAfterSubmission();
+	FailsOnceEverySlotIsPending();
+	DroppedListsGetReclaimed();
+	ResetRunsOutsideTheLock();
+	return 0;
+}
@@ -0,0 +1,136 @@
+#include "Check.h"
+#include "BatchSchedule.h"
+
+#include <map>
+
+//FSR2 2.1 pass ids, negative keys are clears and copies
+enum Pass
+{
+	DepthClip,
+	ReconstructPreviousDepth,
+	Lock,
+	Accumulate,
+	AccumulateSharpen,
+	Rcas,
+	ComputeLuminancePyramid,
+	GenerateReactive,
+	Clear = -1,
+};
+
+//Stands in for the D3D12 command list, counts the binds that get past the hooks
+struct RecordingCommandList
+{
+	unsigned int rootSignatureCalls{}, pipelineCalls{};
+};
+
+//what the FSR2 DX12 backend binds for a job through the hooked command list, every pass has its own root signature and pipeline
+static void RecordJob(RecordingCommandList* cmdList, int key)
+{
+	static std::map<int, int> rootSignatures, pipelines;
+
+	BatchedSetComputeRootSignature(cmdList, &rootSignatures[key], [](RecordingCommandList* cmdList, int*) { cmdList->rootSignatureCalls++; });
+	BatchedSetPipelineState(cmdList, &pipelines[key], [](RecordingCommandList* cmdList, int*) { cmdList->pipelineCalls++; });
+}
+
+static const std::vector<int> Frame = { ComputeLuminancePyramid, ReconstructPreviousDepth, DepthClip, Lock, Accumulate };
+
+static void CheckFeatureOrder(const std::vector<std::vector<int>>& jobKeys, const std::vector<std::pair<size_t, size_t>>& order)
+{
+	size_t jobs = 0;
+	for (const auto& keys : jobKeys)
+		jobs += keys.size();
+	CHECK(order.size() == jobs);
+
+	std::vector<size_t> next(jobKeys.size());
+	for (const auto& [feature, job] : order)
+		CHECK(job == next[feature]++);
+}
+
+//the batch execution of ExecuteDeferredJobs, leaves the counters of the batch in batchBinds
+static RecordingCommandList Run(const std::vector<std::vector<int>>& jobKeys)
+{
+	const auto order = InterleaveJobs(jobKeys);
+	CheckFeatureOrder(jobKeys, order);
+
+	RecordingCommandList cmdList;
+	ExecuteBatch(&cmdList, order, [&](size_t feature, size_t job) { RecordJob(&cmdList, jobKeys[feature][job]); });
+
+	return cmdList;
+}
+
+static void AlignedViewsShareBinds()
+{
+	const auto cmdList = Run({ Frame, Frame, Frame });
+
+	CHECK(batchBinds.Jobs == 15);
+	CHECK(batchBinds.PipelineBinds == 5);
+	CHECK(batchBinds.RootSignatureBinds == 5);
+	CHECK(batchBinds.SkippedBinds == 20);
+	CHECK(cmdList.pipelineCalls == 5);
+	CHECK(cmdList.rootSignatureCalls == 5);
+}
+
+//a reset or first frame clears the history first, grouping by position would shift every later pass of that view
+static void ResetViewStaysGrouped()
+{
+	auto reset = Frame;
+	reset.insert(reset.begin(), { Clear, Clear, Clear });
+
+	const auto cmdList = Run({ Frame, reset, Frame });
+
+	CHECK(batchBinds.Jobs == 18);
+	CHECK(cmdList.pipelineCalls == 6);
+}
+
+static void SharpeningAndReactiveMaskDiffer()
+{
+	auto sharpened = Frame;
+	sharpened.back() = AccumulateSharpen;
+	sharpened.push_back(Rcas);
+
+	auto reactive = Frame;
+	reactive.insert(reactive.begin(), GenerateReactive);
+
+	const auto cmdList = Run({ reactive, Frame, sharpened, Frame });
+
+	//every pass gets bound once, however the views differ
+	CHECK(batchBinds.Jobs == 22);
+	CHECK(cmdList.pipelineCalls == 8);
+	CHECK(cmdList.rootSignatureCalls == 8);
+}
+
+static void CrossedOrderStillTerminates()
+{
+	const std::vector<std::vector<int>> jobKeys = { { Lock, Accumulate }, { Accumulate, Lock } };
+	CheckFeatureOrder(jobKeys, InterleaveJobs(jobKeys));
+}
+
+//the engine's binds into other lists, and into the batch list once the batch ran, always reach the driver
+static void OtherCommandListsPassThrough()
+{
+	RecordingCommandList batchList{}, engineList{};
+
+	ExecuteBatch(&batchList, { { 0, 0 }, { 1, 0 } }, [&](size_t, size_t)
+	{
+		RecordJob(&batchList, Lock);
+		RecordJob(&engineList, Lock);
+	});
+
+	CHECK(batchList.pipelineCalls == 1);
+	CHECK(engineList.pipelineCalls == 2);
+	CHECK(batchBinds.CommandList == nullptr);
+
+	RecordJob(&batchList, Lock);
+	CHECK(batchList.pipelineCalls == 2);
+	CHECK(batchList.rootSignatureCalls == 2);
+}
+
+int main()
+{
+	AlignedViewsShareBinds();
+	ResetViewStaysGrouped();
+	SharpeningAndReactiveMaskDiffer();
+	CrossedOrderStillTerminates();
+	OtherCommandListsPassThrough();
+	return 0;
+}
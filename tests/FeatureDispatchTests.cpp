@@ -0,0 +1,151 @@
+#include "Check.h"
+#include "FeatureDispatch.h"
+
+#include <string>
+#include <vector>
+
+/*
+Records the FSR2 calls of every evaluation.
+FSR2 2.1 builds the luminance pyramid every frame either way, auto exposure only changes which exposure the later passes read,
+so the exposure decision shows in the create flags and the frame keeps a single dispatch.
+*/
+struct RecordingCalls : FeatureDispatchCalls
+{
+	std::vector<std::string> calls;
+	unsigned int contexts{}, masks{};
+	//stands in for the ID3D12Resource the shim creates
+	int maskResources[4]{};
+	std::vector<void*> generated, dispatched;
+
+	void CreateContext(bool autoExposure) override
+	{
+		contexts++;
+		calls.push_back(autoExposure ? "create auto exposure" : "create");
+	}
+
+	void* CreateReactiveMask() override
+	{
+		calls.push_back("create reactive mask");
+		return &maskResources[masks++];
+	}
+
+	void GenerateReactiveMask(void* reactiveMask) override
+	{
+		calls.push_back("generate reactive mask");
+		generated.push_back(reactiveMask);
+	}
+
+	void Dispatch(void* reactiveMask) override
+	{
+		calls.push_back("dispatch");
+		dispatched.push_back(reactiveMask);
+	}
+};
+
+static RecordingCalls Frames(FeatureDispatch& dispatch, unsigned int count, const FeatureInputs& inputs)
+{
+	RecordingCalls recording;
+
+	for (unsigned int i = 0; i < count; i++)
+		dispatch.Evaluate(inputs, recording);
+
+	return recording;
+}
+
+static RecordingCalls Frames(FeatureDispatch& dispatch, unsigned int count, bool exposureBound)
+{
+	FeatureInputs inputs;
+	inputs.ExposureBound = exposureBound;
+	return Frames(dispatch, count, inputs);
+}
+
+static void EngineExposureKeepsAutoExposureOff()
+{
+	FeatureDispatch dispatch(false, false);
+	CHECK(!dispatch.ContextCreated());
+
+	const auto recording = Frames(dispatch, 3, true);
+	CHECK((recording.calls == std::vector<std::string>{ "create", "dispatch", "dispatch", "dispatch" }));
+	CHECK(!dispatch.AutoExposure());
+}
+
+//neither the create flag nor an exposure texture, FSR2 has to compute the exposure itself
+static void MissingExposureTurnsAutoExposureOn()
+{
+	FeatureDispatch dispatch(false, false);
+
+	const auto recording = Frames(dispatch, 3, false);
+	CHECK((recording.calls == std::vector<std::string>{ "create auto exposure", "dispatch", "dispatch", "dispatch" }));
+	CHECK(dispatch.AutoExposure());
+}
+
+static void RequestedAutoExposureWins()
+{
+	FeatureDispatch dispatch(true, false);
+
+	Frames(dispatch, 1, true);
+	CHECK(dispatch.AutoExposure());
+}
+
+//the context keeps its history, a later binding change doesn't recreate it
+static void ContextGetsCreatedOnce()
+{
+	FeatureDispatch dispatch(false, false);
+
+	auto first = Frames(dispatch, 2, true);
+	auto second = Frames(dispatch, 2, false);
+	CHECK(first.contexts == 1);
+	CHECK(second.contexts == 0);
+	CHECK((second.calls == std::vector<std::string>{ "dispatch", "dispatch" }));
+	CHECK(!dispatch.AutoExposure());
+}
+
+//one extra pass per frame, always into the mask the feature created on its first frame
+static void GeneratesTheReactiveMaskIntoOneResource()
+{
+	FeatureDispatch dispatch(false, true);
+	FeatureInputs inputs;
+	inputs.OpaqueColorBound = true;
+
+	const auto recording = Frames(dispatch, 3, inputs);
+	CHECK((recording.calls == std::vector<std::string>{ "create auto exposure", "create reactive mask",
+		"generate reactive mask", "dispatch", "generate reactive mask", "dispatch", "generate reactive mask", "dispatch" }));
+	CHECK(recording.masks == 1);
+	CHECK(dispatch.ReactiveMask() != nullptr);
+	CHECK((recording.generated == std::vector<void*>(3, dispatch.ReactiveMask())));
+	CHECK((recording.dispatched == std::vector<void*>(3, dispatch.ReactiveMask())));
+}
+
+static void EngineMaskOrNoOpaqueColorSkipsThePass()
+{
+	FeatureDispatch dispatch(false, true);
+	FeatureInputs inputs;
+	inputs.ReactiveMaskBound = true;
+	inputs.OpaqueColorBound = true;
+
+	auto recording = Frames(dispatch, 2, inputs);
+	CHECK((recording.calls == std::vector<std::string>{ "create auto exposure", "dispatch", "dispatch" }));
+	CHECK((recording.dispatched == std::vector<void*>(2, nullptr)));
+
+	inputs.ReactiveMaskBound = false;
+	inputs.OpaqueColorBound = false;
+	recording = Frames(dispatch, 2, inputs);
+	CHECK((recording.calls == std::vector<std::string>{ "dispatch", "dispatch" }));
+
+	FeatureDispatch disabled(false, false);
+	inputs.OpaqueColorBound = true;
+	recording = Frames(disabled, 2, inputs);
+	CHECK(recording.masks == 0);
+	CHECK(disabled.ReactiveMask() == nullptr);
+}
+
+int main()
+{
+	EngineExposureKeepsAutoExposureOff();
+	MissingExposureTurnsAutoExposureOn();
+	RequestedAutoExposureWins();
+	ContextGetsCreatedOnce();
+	GeneratesTheReactiveMaskIntoOneResource();
+	EngineMaskOrNoOpaqueColorSkipsThePass();
+	return 0;
+}
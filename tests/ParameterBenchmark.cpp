@@ -0,0 +1,115 @@
+#include "pch.h"
+#include "Dx12ParameterImpl.h"
+#include "CyberFsrExt.h"
+#include "Check.h"
+
+#include <chrono>
+
+/*
+Cost of handing the per frame inputs to the shim, the per key Set calls an engine makes every frame against one CyberFSR.SetFrameParameters call.
+Resources stay null so neither path pays for the debug names, what's left is the virtual calls and the key lookups.
+The block goes through the real CyberFSR.SetFrameParameters export from FrameParameters.cpp, validation included.
+The optimal settings callback Get hands out lives with the other NGX entry points and isn't timed, so it is stubbed.
+*/
+
+NVSDK_NGX_Result NVSDK_CONV NVSDK_NGX_DLSS_GetOptimalSettingsCallback(NVSDK_NGX_Parameter* InParams)
+{
+	return NVSDK_NGX_Result_Fail;
+}
+
+static void SetPerKey(NVSDK_NGX_Parameter* params, unsigned int frame)
+{
+	params->Set("Color", static_cast<ID3D12Resource*>(nullptr));
+	params->Set("Depth", static_cast<ID3D12Resource*>(nullptr));
+	params->Set("MotionVectors", static_cast<ID3D12Resource*>(nullptr));
+	params->Set("Output", static_cast<ID3D12Resource*>(nullptr));
+	params->Set("ExposureTexture", static_cast<ID3D12Resource*>(nullptr));
+	params->Set("TransparencyMask", static_cast<ID3D12Resource*>(nullptr));
+	params->Set("DLSS.Input.Bias.Current.Color.Mask", static_cast<ID3D12Resource*>(nullptr));
+	params->Set("Jitter.Offset.X", 0.25f);
+	params->Set("Jitter.Offset.Y", -0.25f);
+	params->Set("MV.Scale.X", 1.0f);
+	params->Set("MV.Scale.Y", 1.0f);
+	params->Set("Reset", 0);
+	params->Set("Sharpness", 0.5f);
+	params->Set("DLSS.Pre.Exposure", 1.0f);
+	params->Set("DLSS.Exposure.Scale", 1.0f);
+	params->Set("DLSS.Render.Subrect.Dimensions.Width", static_cast<int>(1280 + (frame & 1)));
+	params->Set("DLSS.Render.Subrect.Dimensions.Height", 720);
+}
+
+static void SetBlock(NVSDK_NGX_Parameter* params, PFN_CyberFSR_SetFrameParameters setFrameParameters, unsigned int frame)
+{
+	CyberFsrFrameParameters frameParameters = {};
+	frameParameters.Version = CYBERFSR_FRAME_PARAMETERS_VERSION;
+	frameParameters.Size = sizeof(frameParameters);
+	frameParameters.JitterOffsetX = 0.25f;
+	frameParameters.JitterOffsetY = -0.25f;
+	frameParameters.MVScaleX = 1.0f;
+	frameParameters.MVScaleY = 1.0f;
+	frameParameters.Sharpness = 0.5f;
+	frameParameters.PreExposure = 1.0f;
+	frameParameters.RenderSubrectWidth = 1280 + (frame & 1);
+	frameParameters.RenderSubrectHeight = 720;
+
+	CHECK(setFrameParameters(params, &frameParameters) == NVSDK_NGX_Result_Success);
+}
+
+//a version 1 block leaves the appended fields alone, anything shorter gets rejected
+static void ChecksTheSize(Dx12ParameterImpl& parameters, PFN_CyberFSR_SetFrameParameters setFrameParameters)
+{
+	CyberFsrFrameParameters frameParameters = {};
+	frameParameters.Version = 1;
+	frameParameters.Size = static_cast<unsigned int>(offsetof(CyberFsrFrameParameters, PreExposure));
+	frameParameters.PreExposure = 2.0f;
+
+	parameters.PreExposure = 1.0f;
+	CHECK(setFrameParameters(&parameters, &frameParameters) == NVSDK_NGX_Result_Success);
+	CHECK(parameters.PreExposure == 1.0f);
+
+	frameParameters.Size -= sizeof(unsigned int);
+	CHECK(setFrameParameters(&parameters, &frameParameters) == NVSDK_NGX_Result_FAIL_InvalidParameter);
+
+	//0 is unset, like a PreExposure the engine never Set
+	frameParameters.Size = sizeof(frameParameters);
+	frameParameters.PreExposure = 0.0f;
+	CHECK(setFrameParameters(&parameters, &frameParameters) == NVSDK_NGX_Result_Success);
+	CHECK(parameters.PreExposure == 1.0f);
+}
+
+template<class F>
+static double NanosecondsPerFrame(unsigned int frames, F&& setFrame)
+{
+	const auto start = std::chrono::steady_clock::now();
+	for (unsigned int frame = 0; frame < frames; frame++)
+		setFrame(frame);
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+
+	return std::chrono::duration<double, std::nano>(elapsed).count() / frames;
+}
+
+int main()
+{
+	constexpr unsigned int Frames = 1000000;
+
+	Dx12ParameterImpl parameters;
+	NVSDK_NGX_Parameter* params = &parameters;
+
+	void* setter = nullptr;
+	params->Get("CyberFSR.SetFrameParameters", &setter);
+	auto setFrameParameters = reinterpret_cast<PFN_CyberFSR_SetFrameParameters>(setter);
+	CHECK(setFrameParameters != nullptr);
+	ChecksTheSize(parameters, setFrameParameters);
+
+	//warm up the key map before timing
+	SetPerKey(params, 0);
+
+	const double perKey = NanosecondsPerFrame(Frames, [&](unsigned int frame) { SetPerKey(params, frame); });
+	const double block = NanosecondsPerFrame(Frames, [&](unsigned int frame) { SetBlock(params, setFrameParameters, frame); });
+
+	printf("17 Set calls:             %8.1f ns/frame\n", perKey);
+	printf("1 SetFrameParameters call: %8.1f ns/frame\n", block);
+	printf("render size %ux%u\n", parameters.Width, parameters.Height);
+
+	return 0;
+}
@@ -0,0 +1,157 @@
+#include "Check.h"
+#include "QualitySweep.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+static std::vector<QualitySweep::Step> Steps()
+{
+	return {
+		{ "MaxQuality", 1, 0.0f },
+		{ "MaxPerf", 0, 0.0f },
+	};
+}
+
+//synthetic frame times 1..count ms, the shim takes a tenth of each frame
+static void Frames(QualitySweep& sweep, unsigned int count, unsigned int width, unsigned int height, bool* finished = nullptr)
+{
+	for (unsigned int i = 1; i <= count; i++)
+	{
+		const bool last = sweep.OnFrame(i, i * 0.1, width, height);
+		if (finished)
+			*finished |= last;
+	}
+}
+
+static void WaitsForTheStart()
+{
+	QualitySweep sweep(Steps(), { 5, 0, 0, 10 });
+
+	Frames(sweep, 100, 1707, 960);
+	CHECK(!sweep.Active());
+	CHECK(sweep.Results()[0].FrameTimes.empty());
+
+	sweep.Start();
+	sweep.OnOptimalSettings(1707, 960);
+	CHECK(sweep.Active());
+
+	//the start delay is skipped entirely
+	Frames(sweep, 5, 1707, 960);
+	CHECK(sweep.Results()[0].FrameTimes.empty());
+
+	Frames(sweep, 10, 1707, 960);
+	CHECK(sweep.Results()[0].FrameTimes.size() == 10);
+	CHECK(sweep.Results()[0].FrameTimes.front() == 1.0);
+	CHECK(std::string(sweep.CurrentStep().Name) == "MaxPerf");
+}
+
+//the engine keeps rendering at the previous step's size until it queries the optimal settings again
+static void HoldsUntilTheRenderSizeSwitches()
+{
+	QualitySweep sweep(Steps(), { 0, 1000, 2, 10 });
+	sweep.Start();
+
+	sweep.OnOptimalSettings(1707, 960);
+	Frames(sweep, 12, 1707, 960);
+	CHECK(std::string(sweep.CurrentStep().Name) == "MaxPerf");
+
+	Frames(sweep, 500, 1707, 960);
+	CHECK(sweep.Results()[1].FrameTimes.empty());
+
+	bool finished = false;
+	sweep.OnOptimalSettings(1280, 720);
+	Frames(sweep, 12, 1280, 720, &finished);
+	CHECK(finished);
+	CHECK(!sweep.Active());
+
+	const auto& result = sweep.Results()[1];
+	CHECK(result.FrameTimes.size() == 10);
+	//the two warmup frames are dropped
+	CHECK(result.FrameTimes.front() == 3.0);
+	CHECK(result.RenderWidth == 1280 && result.RenderHeight == 720);
+	CHECK(!result.SizeMismatch);
+}
+
+static void FlagsAStepThatNeverSwitched()
+{
+	QualitySweep sweep(Steps(), { 0, 20, 0, 10 });
+	sweep.Start();
+
+	sweep.OnOptimalSettings(1707, 960);
+	Frames(sweep, 10, 1707, 960);
+
+	//the engine never asks again, after the settle frames the step gets measured at the old size
+	Frames(sweep, 19, 1707, 960);
+	CHECK(sweep.Results()[1].FrameTimes.empty());
+
+	bool finished = false;
+	Frames(sweep, 11, 1707, 960, &finished);
+	CHECK(finished);
+
+	CHECK(!sweep.Results()[0].SizeMismatch);
+	CHECK(sweep.Results()[1].SizeMismatch);
+	CHECK(sweep.Results()[1].ExpectedWidth == 0);
+}
+
+//split screen evaluates two features per frame, only the first one counts frames
+static void FollowsOneFeature()
+{
+	QualitySweep sweep(Steps(), { 0, 0, 0, 10 });
+	sweep.Start();
+
+	CHECK(sweep.Follows(7));
+	CHECK(!sweep.Follows(3));
+	CHECK(sweep.Follows(7));
+
+	//the next feature takes over once the followed one is gone
+	sweep.OnFeatureReleased(3);
+	CHECK(!sweep.Follows(3));
+	sweep.OnFeatureReleased(7);
+	CHECK(sweep.Follows(3));
+	CHECK(!sweep.Follows(7));
+}
+
+static std::string ReadFile(const std::filesystem::path& path)
+{
+	std::ifstream file(path);
+	std::stringstream content;
+	content << file.rdbuf();
+	return content.str();
+}
+
+static void WritesTheReport()
+{
+	QualitySweep sweep(Steps(), { 0, 0, 0, 100 });
+	sweep.Start();
+
+	sweep.OnOptimalSettings(1707, 960);
+	Frames(sweep, 100, 1707, 960);
+	sweep.OnOptimalSettings(1280, 720);
+	Frames(sweep, 100, 1707, 960);
+
+	const auto path = std::filesystem::temp_directory_path() / "CyberFSR_QualitySweepTests";
+	CHECK(sweep.WriteReport(path));
+
+	const auto csv = ReadFile(path.string() + ".csv");
+	const auto json = ReadFile(path.string() + ".json");
+
+	//average and nearest-rank p95 and p99 of 1..100 ms
+	CHECK(csv.find("\n0,MaxQuality,0,1707,960,1707,960,0,100,50.5,95,99,5.05,9.5,9.9\n") != std::string::npos);
+	CHECK(csv.find("\n1,MaxPerf,0,1280,720,1707,960,1,100,") != std::string::npos);
+	CHECK(json.find("\"perfQuality\":\"MaxPerf\"") != std::string::npos);
+	CHECK(json.find("\"sizeMismatch\":true") != std::string::npos);
+
+	std::filesystem::remove(path.string() + ".csv");
+	std::filesystem::remove(path.string() + ".json");
+}
+
+int main()
+{
+	WaitsForTheStart();
+	HoldsUntilTheRenderSizeSwitches();
+	FlagsAStepThatNeverSwitched();
+	FollowsOneFeature();
+	WritesTheReport();
+	return 0;
+}
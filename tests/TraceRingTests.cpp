@@ -0,0 +1,44 @@
+#include "Check.h"
+#include "TraceRing.h"
+
+constexpr size_t Capacity = 8;
+
+static void QuietRingKeepsEverything()
+{
+	const auto partial = ValidTraceEvents(5, 5, Capacity);
+	CHECK(partial.Begin == 0 && partial.End == 5);
+
+	//full ring, nothing recorded meanwhile, the slot of the next write still holds the oldest event
+	const auto full = ValidTraceEvents(20, 20, Capacity);
+	CHECK(full.Begin == 13 && full.End == 20);
+}
+
+//writes into the free slots of a ring that isn't full yet can't tear a copied event
+static void WritesIntoFreeSlots()
+{
+	const auto range = ValidTraceEvents(3, 6, Capacity);
+	CHECK(range.Begin == 0 && range.End == 3);
+
+	//the writer wrapped around and is working on slot 0, event 0
+	const auto wrapped = ValidTraceEvents(3, 8, Capacity);
+	CHECK(wrapped.Begin == 1 && wrapped.End == 3);
+}
+
+static void DropsOverwrittenEvents()
+{
+	//events 12..19 copied, the writer finished 20 and 21 and may be halfway through 22, which replaces event 14
+	const auto range = ValidTraceEvents(20, 22, Capacity);
+	CHECK(range.Begin == 15 && range.End == 20);
+
+	//a full lap during the copy leaves nothing trustworthy
+	const auto lapped = ValidTraceEvents(20, 40, Capacity);
+	CHECK(lapped.Begin == lapped.End);
+}
+
+int main()
+{
+	QuietRingKeepsEverything();
+	WritesIntoFreeSlots();
+	DropsOverwrittenEvents();
+	return 0;
+}